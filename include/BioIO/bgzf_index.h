@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_BGZF_INDEX_H_
+#define BIOIO_BGZF_INDEX_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <exception>
+
+/**
+ * @brief Exception class for BgzfIndex class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw BgzfIndexException(msg);
+ *
+ * @example
+ *   throw BgzfIndexException("Exception message");
+ */
+class BgzfIndexException : public std::exception {
+ public:
+  BgzfIndexException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  BgzfIndexException(const BgzfIndexException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
+
+/*
+ * Start of a BGZF block in the compressed and the uncompressed data.
+ */
+struct BgzfBlock {
+  uint64_t compressed_offset;
+  uint64_t uncompressed_offset;
+};
+
+/**
+ * @brief Index of the blocks of a BGZF file, as stored in .gzi files.
+ *
+ * A .gzi file holds the number of blocks followed by the compressed and
+ * uncompressed offset of each block but the first, all as little-endian
+ * 64-bit integers, and is written by bgzip -i or samtools faidx.
+ *
+ * @example
+ *   BgzfIndex index = BgzfIndex::Load("genome.fa.gz.gzi");
+ *   const BgzfBlock &block = index.Locate(offset);
+ */
+class BgzfIndex
+{
+ public:
+  BgzfIndex();
+
+  /*
+   * Index the blocks of a BGZF file. Only the block headers and trailers
+   * are read, so nothing is inflated.
+   */
+  static BgzfIndex Build(const std::string &file);
+
+  /*
+   * Load an index from a .gzi file.
+   */
+  static BgzfIndex Load(const std::string &file);
+
+  /*
+   * Write the index to a .gzi file.
+   */
+  void Save(const std::string &file) const;
+
+  /*
+   * Return the number of blocks including the first.
+   */
+  size_t size() const;
+
+  /*
+   * Return the blocks in file order, starting with the first at offset 0.
+   */
+  const std::vector<BgzfBlock> &blocks() const;
+
+  /*
+   * Return the block holding the given uncompressed offset.
+   */
+  const BgzfBlock &Locate(uint64_t offset) const;
+
+ private:
+  /*
+   * Blocks in file order.
+   */
+  std::vector<BgzfBlock> blocks_;
+};
+
+#endif  // BIOIO_BGZF_INDEX_H_
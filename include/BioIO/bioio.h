@@ -21,8 +21,19 @@
 #ifndef BIOIO_BIOIO_H_
 #define BIOIO_BIOIO_H_
 
+#include <BioIO/packed_seq.h>
 #include <BioIO/seq_entry.h>
+#include <BioIO/seq_view.h>
+#include <BioIO/seq_batch.h>
+#include <BioIO/seq_chunk.h>
 #include <BioIO/fasta_reader.h>
 #include <BioIO/fastq_reader.h>
+#include <BioIO/bgzf_index.h>
+#include <BioIO/fasta_index.h>
+#include <BioIO/fastq_index.h>
+#include <BioIO/indexed_fasta_reader.h>
+#include <BioIO/paired_fastq_reader.h>
+#include <BioIO/parallel_fasta_reader.h>
+#include <BioIO/parallel_fastq_reader.h>
 
 #endif  // BIOIO_BIOIO_H_
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_FASTA_INDEX_H_
+#define BIOIO_FASTA_INDEX_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <unordered_map>
+
+/**
+ * @brief Exception class for FastaIndex class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw FastaIndexException(msg);
+ *
+ * @example
+ *   throw FastaIndexException("Exception message");
+ */
+class FastaIndexException : public std::exception {
+ public:
+  FastaIndexException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  FastaIndexException(const FastaIndexException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
+
+/*
+ * Location of one sequence in a FASTA file, as stored in a .fai line.
+ */
+struct FastaIndexEntry {
+  /*
+   * Name of sequence, that is the header up to the first whitespace.
+   */
+  std::string name;
+
+  /*
+   * Number of bases in the sequence.
+   */
+  uint64_t length;
+
+  /*
+   * Byte offset of the first base in the file.
+   */
+  uint64_t offset;
+
+  /*
+   * Number of bases on each line.
+   */
+  uint64_t line_bases;
+
+  /*
+   * Number of bytes on each line including the line end.
+   */
+  uint64_t line_width;
+};
+
+/**
+ * @brief samtools compatible FASTA index.
+ *
+ * The index records for each sequence where its bases start and how its
+ * lines are wrapped, so the byte offset of any base can be computed. All
+ * lines of a sequence but the last must hold the same number of bases.
+ *
+ * @example
+ *   FastaIndex index = FastaIndex::Build("genome.fa");
+ *   index.Save("genome.fa.fai");
+ */
+class FastaIndex
+{
+ public:
+  FastaIndex();
+
+  /*
+   * Index the FASTA file. Compressed files are indexed by their
+   * uncompressed offsets.
+   */
+  static FastaIndex Build(const std::string &file);
+
+  /*
+   * Load an index from a .fai file.
+   */
+  static FastaIndex Load(const std::string &file);
+
+  /*
+   * Write the index to a .fai file.
+   */
+  void Save(const std::string &file) const;
+
+  /*
+   * Return the number of indexed sequences.
+   */
+  size_t size() const;
+
+  /*
+   * Return the indexed sequences in file order.
+   */
+  const std::vector<FastaIndexEntry> &entries() const;
+
+  /*
+   * Return the entry of the named sequence or nullptr if there is none.
+   */
+  const FastaIndexEntry *Find(const std::string &name) const;
+
+  /*
+   * Return the byte offset of base pos of entry.
+   */
+  static uint64_t BaseOffset(const FastaIndexEntry &entry, const uint64_t pos);
+
+ private:
+  /*
+   * Indexed sequences in file order.
+   */
+  std::vector<FastaIndexEntry> entries_;
+
+  /*
+   * Position in entries_ of each sequence name. Only the first of sequences
+   * with the same name can be found.
+   */
+  std::unordered_map<std::string, size_t> names_;
+
+  /*
+   * Append entry to the index.
+   */
+  void Add(const FastaIndexEntry &entry);
+};
+
+#endif  // BIOIO_FASTA_INDEX_H_
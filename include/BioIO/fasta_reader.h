@@ -23,11 +23,15 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include <fstream>
 #include <exception>
 #include <iostream>
 
 #include <BioIO/seq_entry.h>
+#include <BioIO/seq_view.h>
+#include <BioIO/seq_batch.h>
+#include <BioIO/seq_chunk.h>
 #include <BioIO/read_buffer.h>
 
 /**
@@ -60,6 +64,11 @@ class FastaReader
  public:
   FastaReader(const std::string &file);
 
+  /*
+   * Parse size chars of FASTA data in memory, which must outlive the reader.
+   */
+  FastaReader(const char *data, const size_t size);
+
   ~FastaReader();
 
   /*
@@ -67,6 +76,57 @@ class FastaReader
    */
   std::unique_ptr<SeqEntry> NextEntry();
 
+  /*
+   * Return a view of the next sequence entry without copying it out of the
+   * read buffer. The view is valid until the next call to the reader.
+   */
+  SeqView NextView();
+
+  /*
+   * Read up to n sequence entries into batch and return the number read,
+   * which is 0 at end-of-file. The batch is resized to the number read.
+   * Entries already in the batch are overwritten in place, so reusing one
+   * batch for all calls keeps the strings' capacity and avoids allocating
+   * per record.
+   */
+  size_t NextBatch(std::vector<SeqEntry> &batch, const size_t n);
+
+  /*
+   * Replace the contents of batch with up to n sequence entries and return
+   * the number read, which is 0 at end-of-file. The records are copied
+   * straight into the batch arenas.
+   */
+  size_t NextBatch(SeqBatch &batch, const size_t n);
+
+  /*
+   * Read the next chunk of at most size bases into chunk and return false at
+   * end-of-file. A record is read in chunks until one is marked last, and
+   * each chunk after the first repeats the last overlap bases of the one
+   * before, so memory use is bounded by size however long the record is.
+   * Pass the same chunk, size and overlap for all chunks of a record and do
+   * not mix with the other read calls mid-record.
+   */
+  bool NextChunk(SeqChunk &chunk, const size_t size,
+                 const size_t overlap = 0);
+
+  /*
+   * Store the sequences of the entries from NextEntry and NextBatch into
+   * a vector in packed form, see SeqEntry::Pack. Sequences are packed from
+   * the record views, so single line sequences are packed straight from
+   * the read buffer and multi-line ones once collected. Views and SeqBatch
+   * are not affected. Packing is lossy and the
+   * seq() of packed entries is empty until SeqEntry::Unpack. Throws unless
+   * the sequence type is nucleotide.
+   */
+  void set_packed(const bool packed);
+
+  /*
+   * Set the type of the sequences in the entries from NextEntry and
+   * NextBatch, which is nucleotide by default. Throws if sequences are
+   * packed and type is not nucleotide.
+   */
+  void set_type(const SeqEntry::SeqType type);
+
   /*
    * Tells if more sequence entries can be found.
    */
@@ -80,43 +140,62 @@ class FastaReader
   static const auto kBufferSize = 640 * 1024;
 
   /*
-   * Size of sequence name buffer used to temporary store the sequence name while
-   * parsing a FASTA file. The size of this buffer is determined by kMaxNameSize,
-   * which must be larger than the longest name or undefined things will happen.
-  */
-  static const auto kMaxNameSize = 1024;
+   * Temporary file reading buffer.
+   */
+  ReadBuffer read_buffer_;
 
   /*
-   * Size of sequence buffer used to temporary store the sequence  while parsing
-   * a FASTA file. The size of this buffer is determined by kMaxSeqSize, which
-   * must be larger than the longest sequence or undefined things will happen.
+   * Temporary buffer for collecting a read name. The buffer grows on demand
+   * and keeps its capacity, so it ends up the size of the longest name.
    */
-  static const auto kMaxSeqSize = 300000000;
+  std::string name_buffer_;
 
   /*
-   * Temporary file reading buffer.
+   * Temporary buffer for collecting a read sequence. The buffer grows on
+   * demand and keeps its capacity, so it ends up the size of the longest
+   * sequence.
    */
-  ReadBuffer read_buffer_;
+  std::string seq_buffer_;
+
+  /*
+   * True while NextChunk is part way through a record.
+   */
+  bool in_record_;
+
+  /*
+   * True if entries are emitted with packed sequences.
+   */
+  bool packed_;
+
+  /*
+   * Type of the sequences read.
+   */
+  SeqEntry::SeqType type_;
 
   /*
-   * Temporary buffer for collecting a read name.
+   * Get the next FASTA header in the buffer into name_buffer_.
    */
-  char *name_buffer_;
+  void GetName();
 
   /*
-   * Temporary buffer for collecting a read sequence.
+   * Get the next FASTA sequence in the buffer into seq_buffer_.
    */
-  char *seq_buffer_;
+  void GetSeq();
 
   /*
-   * Get the next FASTA header in the buffer.
+   * Append sequence chars to seq until it holds size chars or a '>' starts
+   * a line, stepping over whitespace. line_start tells if the next char in
+   * the buffer begins a line. Returns true if the record ended, that is a
+   * '>' or end-of-file follows the appended chars.
    */
-  void GetName(std::unique_ptr<SeqEntry> &seq_entry);
+  bool FillSeq(std::string &seq, const size_t size, bool line_start);
 
   /*
-   * Get the next FASTA sequence in the buffer.
+   * Point view at the next record if it is complete in the unread part of
+   * the buffer and consume it. Returns false, consuming nothing, if the
+   * record continues past the buffer or is malformed.
    */
-  void GetSeq(std::unique_ptr<SeqEntry> &seq_entry);
+  bool ViewRecord(SeqView &view);
 
   /*
    * Return true on \n or \r.
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_FASTQ_INDEX_H_
+#define BIOIO_FASTQ_INDEX_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <exception>
+
+/**
+ * @brief Exception class for FastqIndex class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw FastqIndexException(msg);
+ *
+ * @example
+ *   throw FastqIndexException("Exception message");
+ */
+class FastqIndexException : public std::exception {
+ public:
+  FastqIndexException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  FastqIndexException(const FastqIndexException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
+
+/**
+ * @brief Index of the byte offsets of every interval'th record in an
+ * uncompressed FASTQ file.
+ *
+ * The index file holds the magic "BFQI" followed by the interval, the number
+ * of records and the number of offsets, and then the offsets, all as
+ * little-endian 64-bit integers.
+ *
+ * @example
+ *   FastqIndex index = FastqIndex::Build("reads.fq");
+ *   index.Save("reads.fq.fqi");
+ *
+ *   FastqReader reader("reads.fq");
+ *   reader.SeekRecord(index, 1000000);
+ */
+class FastqIndex
+{
+ public:
+  /*
+   * Default number of records between indexed offsets.
+   */
+  static const uint64_t kDefaultInterval = 1024;
+
+  FastqIndex();
+
+  /*
+   * Index every interval'th record of a FASTQ file.
+   */
+  static FastqIndex Build(const std::string &file,
+                          const uint64_t interval = kDefaultInterval);
+
+  /*
+   * Load an index from an index file.
+   */
+  static FastqIndex Load(const std::string &file);
+
+  /*
+   * Write the index to an index file.
+   */
+  void Save(const std::string &file) const;
+
+  /*
+   * Return the number of records between indexed offsets.
+   */
+  uint64_t interval() const;
+
+  /*
+   * Return the number of records in the indexed file.
+   */
+  uint64_t records() const;
+
+  /*
+   * Return the byte offsets of records 0, interval, 2 * interval and so on.
+   */
+  const std::vector<uint64_t> &offsets() const;
+
+  /*
+   * Return the offset of the closest indexed record at or before record and
+   * set skip to the number of records between the two. Throws if record is
+   * past the last record.
+   */
+  uint64_t Locate(uint64_t record, uint64_t &skip) const;
+
+ private:
+  /*
+   * Number of records between indexed offsets.
+   */
+  uint64_t interval_;
+
+  /*
+   * Number of records in the indexed file.
+   */
+  uint64_t records_;
+
+  /*
+   * Byte offsets of the indexed records.
+   */
+  std::vector<uint64_t> offsets_;
+};
+
+#endif  // BIOIO_FASTQ_INDEX_H_
@@ -23,13 +23,19 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include <fstream>
 #include <exception>
 #include <iostream>
 
 #include <BioIO/seq_entry.h>
+#include <BioIO/seq_view.h>
+#include <BioIO/seq_batch.h>
 #include <BioIO/read_buffer.h>
 
+class FastqIndex;
+
 /**
  * @brief Exception class for FastqReader class.
  *
@@ -63,8 +69,51 @@ class FastqReaderException : public std::exception {
 class FastqReader
 {
  public:
+  /*
+   * Default FASTQ score encoding.
+   */
+  static const auto kDefaultEncoding = 33;
+
+  /*
+   * FASTQ score encodings. Solexa scores are converted to Phred scores.
+   * Automatic detection samples the scores of the first kDetectRecords
+   * records in the read buffer on the first read: chars below ';' mean
+   * Phred+33, as do samples within ';'-'K', which Phred+64 data would only
+   * have at scores up to 11. Otherwise chars below '@' mean Solexa and the
+   * rest Phred+64.
+   */
+  enum class Encoding {
+    automatic,
+    phred33,
+    phred64,
+    solexa
+  };
+
+  /*
+   * Number of records sampled to detect the encoding.
+   */
+  static const size_t kDetectRecords = 1000;
+
+  /*
+   * How scores are stored in the entries from NextEntry and NextBatch into
+   * a vector. Scores are decoded as read, kept raw and decoded on the first
+   * call to SeqEntry::scores(), or skipped and left empty.
+   */
+  enum class ScoreMode {
+    decode,
+    lazy,
+    skip
+  };
+
   FastqReader(const std::string &file);
   FastqReader(const std::string &file, const int encoding);
+  FastqReader(const std::string &file, const Encoding encoding);
+
+  /*
+   * Parse size chars of FASTQ data in memory, which must outlive the reader.
+   */
+  FastqReader(const char *data, const size_t size,
+              const int encoding = kDefaultEncoding);
 
   ~FastqReader();
 
@@ -74,41 +123,85 @@ class FastqReader
   std::unique_ptr<SeqEntry> NextEntry();
 
   /*
-   * Tells if more sequence entries can be found.
+   * Return a view of the next sequence entry without copying it out of the
+   * read buffer. The scores are left encoded. The view is valid until the
+   * next call to the reader.
    */
-  bool HasNextEntry();
+  SeqView NextView();
 
- private:
   /*
-   * Default FASTQ score encoding.
+   * Read up to n sequence entries into batch and return the number read,
+   * which is 0 at end-of-file. The batch is resized to the number read.
+   * Entries already in the batch are overwritten in place, so reusing one
+   * batch for all calls keeps the strings' capacity and avoids allocating
+   * per record.
    */
-  static const auto kDefaultEncoding = 33;
+  size_t NextBatch(std::vector<SeqEntry> &batch, const size_t n);
 
   /*
-   * Size of custom buffer used to read from a FASTQ file a chunk of data this size
+   * Replace the contents of batch with up to n sequence entries and return
+   * the number read, which is 0 at end-of-file. The records are copied
+   * straight into the batch arenas. Scores are decoded unless the score
+   * mode is skip.
    */
-  static const auto kBufferSize  = 640 * 1024;
+  size_t NextBatch(SeqBatch &batch, const size_t n);
+
+  /*
+   * Append the next sequence entry to batch as NextBatch does and return
+   * true, or return false at end-of-file.
+   */
+  bool AppendEntry(SeqBatch &batch);
+
+  /*
+   * Store the sequences of the entries from NextEntry and NextBatch into
+   * a vector in packed form, see SeqEntry::Pack, straight from the record
+   * views in the read buffer. Records split across the end of the buffer
+   * are collected first. Views and SeqBatch are not affected. Packing is lossy and the
+   * seq() of packed entries is empty until SeqEntry::Unpack.
+   */
+  void set_packed(const bool packed);
+
+  /*
+   * Return the score encoding, detecting it first in automatic mode. Offsets
+   * other than 64 given as an int are reported as phred33.
+   */
+  Encoding encoding();
+
+  /*
+   * Set how scores are stored, see ScoreMode. The default is decode.
+   */
+  void set_score_mode(const ScoreMode mode);
+
+  /*
+   * Tells if more sequence entries can be found.
+   */
+  bool HasNextEntry();
 
   /*
-   * Size of sequence name buffer used to temporary store the sequence name while
-   * parsing a FASTQ file. The size of this buffer is determined by kMaxNameSize,
-   * which must be larger than the longest name or undefined things will happen.
-  */
-  static const auto kMaxNameSize = 1024;
+   * Return the byte offset of the next unread char, which is the offset of
+   * the next record between records.
+   */
+  uint64_t Offset() const;
 
   /*
-   * Size of sequence buffer used to temporary store the sequence while parsing
-   * a FASTQ file. The size of this buffer is determined by kMaxSeqSize, which
-   * must be larger than the longest sequence or undefined things will happen.
+   * Continue reading at the given record number, counted from 0, using an
+   * index of this file. Clears any shard set by SeekShard.
    */
-  static const auto kMaxSeqSize = 4096;
+  void SeekRecord(const FastqIndex &index, const uint64_t record);
 
   /*
-   * Size of scores buffer used to temporary store the scores while parsing
-   * a FASTQ file. The size of this buffer is determined by kMaxScoresSize, which
-   * must be larger than the longest sequence or undefined things will happen.
+   * Restrict reading to shard number shard of shards byte ranges of equal
+   * size. Each record belongs to the shard its first byte falls in, so
+   * reading all shards yields every record exactly once. Requires that the
+   * input can seek.
    */
-  static const auto kMaxScoresSize = 4096;
+  void SeekShard(const size_t shard, const size_t shards);
+
+ private:
+  /*
+   * Size of custom buffer used to read from a FASTQ file a chunk of data this size
+   */
+  static const auto kBufferSize  = 640 * 1024;
 
   /*
    * Temporary file reading buffer.
@@ -121,34 +214,101 @@ class FastqReader
   size_t encoding_;
 
   /*
-   * Temporary buffer for collecting sequence name.
+   * True if scores are Solexa scores, which are offset by 64 and converted
+   * to Phred scores.
+   */
+  bool solexa_;
+
+  /*
+   * True until the encoding is detected in automatic mode.
+   */
+  bool detect_;
+
+  /*
+   * Temporary buffers for collecting sequence name, sequence and scores.
+   * The buffers grow on demand and keep their capacity, so they end up the
+   * size of the longest record and reads of any length can be parsed.
+   */
+  std::string name_buffer_;
+  std::string seq_buffer_;
+  std::string scores_buffer_;
+
+  /*
+   * Offset where the current shard ends and no more records are read.
+   */
+  uint64_t end_offset_;
+
+  /*
+   * Seek to the first record starting at or after offset. Records are
+   * recognised by a line starting with '@', a line starting with '+' two
+   * lines below, and equal sequence and scores lengths.
+   */
+  void Resync(const uint64_t offset);
+
+  /*
+   * True if entries are emitted with packed sequences.
+   */
+  bool packed_;
+
+  /*
+   * How entries store scores.
+   */
+  ScoreMode score_mode_;
+
+  /*
+   * Get the next FASTQ header in the buffer into name_buffer_.
+   */
+  void GetName();
+
+  /*
+   * Get the next FASTQ sequence in the buffer into seq_buffer_.
+   */
+  void GetSeq();
+
+  /*
+   * Get the next FASTQ scores in the buffer into scores_buffer_.
+   */
+  void GetScores();
+
+  /*
+   * Point view at the next record if it is complete in the unread part of
+   * the buffer and consume it. Returns false, consuming nothing, if the
+   * record continues past the buffer or is malformed.
+   */
+  bool ViewRecord(SeqView &view);
+
+  /*
+   * Set the encoding. Automatic leaves it to be detected on the next read.
    */
-  char *name_buffer_;
+  void SetEncoding(const Encoding encoding);
 
   /*
-   * Temporary buffer for collecting sequence.
+   * Detect the encoding from the scores ahead in the read buffer.
    */
-  char *seq_buffer_;
+  void DetectEncoding();
 
   /*
-   * Temporary buffer for collecting scores.
+   * Store encoded scores in entry as set by the score mode.
    */
-  char *scores_buffer_;
+  void SetScores(SeqEntry &entry, const CharSpan &encoded);
 
   /*
-   * Get the next FASTQ header in the buffer.
+   * Decode encoded scores into scores, which must have room for them.
+   * Throws if a score char is below the encoding, or ';' for Solexa, or
+   * above 126.
    */
-  void GetName(std::unique_ptr<SeqEntry> &seq_entry);
+  void DecodeScores(const CharSpan &encoded, uint8_t *scores);
 
   /*
-   * Get the next FASTQ sequence in the buffer.
+   * Replace the contents of line with the next line and consume the line
+   * end.
    */
-  void GetSeq(std::unique_ptr<SeqEntry> &seq_entry);
+  void GetLine(std::string &line);
 
   /*
-   * Get the next FASTQ scores in the buffer.
+   * Skip the next line including the line end.
    */
-  void GetScores(std::unique_ptr<SeqEntry> &seq_entry);
+  void SkipLine();
 
   /*
    * Return true on \n or \r.
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_INDEXED_FASTA_READER_H_
+#define BIOIO_INDEXED_FASTA_READER_H_
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <exception>
+
+#include <BioIO/fasta_index.h>
+#include <BioIO/bgzf_index.h>
+
+class StreamSource;
+
+/**
+ * @brief Exception class for IndexedFastaReader class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw IndexedFastaReaderException(msg);
+ *
+ * @example
+ *   throw IndexedFastaReaderException("Exception message");
+ */
+class IndexedFastaReaderException : public std::exception {
+ public:
+  IndexedFastaReaderException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  IndexedFastaReaderException(const IndexedFastaReaderException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
+
+/**
+ * @brief Random access to regions of an indexed FASTA file.
+ *
+ * Regions are read by seeking straight to the bytes holding them, using the
+ * line layout recorded in the .fai index. BGZF compressed files, as written
+ * by bgzip, are read through their .gzi block index, so only the blocks
+ * covering a region are inflated.
+ *
+ * @example
+ *   IndexedFastaReader reader("genome.fa");
+ *   std::string        seq = reader.Fetch("chr17:41,196,312-41,277,500");
+ */
+class IndexedFastaReader
+{
+ public:
+  /*
+   * Open file using the index in file.fai, and for BGZF compressed files the
+   * block index in file.gzi. Missing indexes are built in memory.
+   */
+  IndexedFastaReader(const std::string &file);
+
+  /*
+   * Open file using the given index.
+   */
+  IndexedFastaReader(const std::string &file, const FastaIndex &index);
+
+  IndexedFastaReader(const IndexedFastaReader &) = delete;
+  IndexedFastaReader &operator=(const IndexedFastaReader &) = delete;
+
+  ~IndexedFastaReader();
+
+  /*
+   * Return the sequence of a region given samtools style as name, name:begin
+   * or name:begin-end with 1-based inclusive positions, which may contain
+   * thousands separators. A name containing ':' is looked up as a whole
+   * first. The end is clamped to the end of the sequence.
+   */
+  std::string Fetch(const std::string &region);
+
+  /*
+   * Return the bases [begin, end) of the named sequence, using 0-based
+   * positions. The end is clamped to the end of the sequence.
+   */
+  std::string Fetch(const std::string &name, uint64_t begin, uint64_t end);
+
+  /*
+   * Replace seq with the bases [begin, end) of the named sequence. Reusing
+   * seq across calls avoids allocating per fetch.
+   */
+  void Fetch(const std::string &name, uint64_t begin, uint64_t end,
+             std::string &seq);
+
+  /*
+   * Return the index of the file.
+   */
+  const FastaIndex &index() const;
+
+ private:
+  /*
+   * Name of the FASTA file.
+   */
+  const std::string file_;
+
+  /*
+   * Index of the file.
+   */
+  FastaIndex index_;
+
+  /*
+   * The FASTA file when uncompressed.
+   */
+  std::ifstream input_;
+
+  /*
+   * The FASTA file when BGZF compressed or nullptr.
+   */
+  std::unique_ptr<StreamSource> bgzf_input_;
+
+  /*
+   * Block index of a BGZF compressed file.
+   */
+  BgzfIndex bgzf_index_;
+
+  /*
+   * Temporary buffer for a compressed BGZF block.
+   */
+  std::string block_buffer_;
+
+  /*
+   * Temporary buffer for the raw bytes of a region, line ends included.
+   */
+  std::string raw_buffer_;
+
+  /*
+   * Open the FASTA file.
+   */
+  void Open();
+
+  /*
+   * Read the size uncompressed bytes starting at offset into raw_buffer_.
+   */
+  void ReadRaw(uint64_t offset, uint64_t size);
+
+  /*
+   * Return the entry of the named sequence or throw if there is none.
+   */
+  const FastaIndexEntry &Entry(const std::string &name) const;
+};
+
+#endif  // BIOIO_INDEXED_FASTA_READER_H_
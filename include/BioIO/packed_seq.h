@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_PACKED_SEQ_H_
+#define BIOIO_PACKED_SEQ_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+
+/**
+ * @brief Exception class for PackedSeq class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw PackedSeqException(msg);
+ *
+ * @example
+ *   throw PackedSeqException("Exception message");
+ */
+class PackedSeqException : public std::exception {
+ public:
+  PackedSeqException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  PackedSeqException(const PackedSeqException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
+
+/**
+ * @brief Nucleotide sequence packed at 2 bits per base.
+ *
+ * A, C, G and T are stored as 0-3, 32 bases per 64-bit word from the low
+ * bits. Any other char is stored as 0 and flagged in a mask of 1 bit per
+ * base, which is only kept when some base is flagged. Packing is lossy:
+ * bases unpack as upper case and flagged bases as N.
+ *
+ * Unused bits are always clear, so whole words can be compared and hashed,
+ * and Kmer returns up to 32 bases as one integer.
+ *
+ * @example
+ *   PackedSeq packed(entry.seq());
+ *
+ *   for (size_t i = 0; i + k <= packed.size(); ++i)
+ *     if (!packed.masked(i, k))
+ *       counts[packed.Kmer(i, k)]++;
+ */
+class PackedSeq
+{
+ public:
+  /*
+   * Number of bases in each word.
+   */
+  static const size_t kBasesPerWord = 32;
+
+  PackedSeq();
+
+  /*
+   * Pack the given sequence.
+   */
+  PackedSeq(const std::string &seq);
+  PackedSeq(const char *seq, const size_t size);
+
+  /*
+   * Replace the contents with the given size bases.
+   */
+  void Assign(const char *seq, const size_t size);
+
+  /*
+   * Return the unpacked sequence.
+   */
+  std::string Unpack() const;
+
+  /*
+   * Replace the contents of seq with the unpacked sequence.
+   */
+  void Unpack(std::string &seq) const;
+
+  /*
+   * Return the number of bases.
+   */
+  size_t size() const;
+
+  /*
+   * Return true if there are no bases.
+   */
+  bool empty() const;
+
+  /*
+   * Remove all bases.
+   */
+  void clear();
+
+  /*
+   * Return the unpacked base at position i.
+   */
+  char operator[](const size_t i) const;
+
+  /*
+   * Return true if the base at position i is not A, C, G or T.
+   */
+  bool masked(const size_t i) const;
+
+  /*
+   * Return true if any of the len bases from position i is flagged.
+   */
+  bool masked(const size_t i, const size_t len) const;
+
+  /*
+   * Return the k bases from position i, with k at most 32, packed into the
+   * low bits of one integer with base i in the lowest two bits.
+   */
+  uint64_t Kmer(const size_t i, const size_t k) const;
+
+  /*
+   * Return the len bases from position i, sliced out of the packed words
+   * without unpacking them.
+   */
+  PackedSeq SubSeq(const size_t i, const size_t len) const;
+
+  /*
+   * Return the packed words.
+   */
+  const std::vector<uint64_t> &words() const;
+
+  /*
+   * Return the mask words, 64 bases per word, which are empty if no base is
+   * flagged.
+   */
+  const std::vector<uint64_t> &mask() const;
+
+  bool operator==(const PackedSeq &other) const;
+  bool operator!=(const PackedSeq &other) const;
+
+ private:
+  /*
+   * Number of bases.
+   */
+  size_t size_;
+
+  /*
+   * Bases at 2 bits each.
+   */
+  std::vector<uint64_t> words_;
+
+  /*
+   * Flags for bases other than ACGT at 1 bit each.
+   */
+  std::vector<uint64_t> mask_;
+};
+
+#endif  // BIOIO_PACKED_SEQ_H_
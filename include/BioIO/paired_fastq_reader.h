@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_PAIRED_FASTQ_READER_H_
+#define BIOIO_PAIRED_FASTQ_READER_H_
+
+#include <string>
+#include <memory>
+#include <future>
+#include <utility>
+#include <cstdint>
+#include <exception>
+
+#include <BioIO/seq_view.h>
+#include <BioIO/seq_entry.h>
+#include <BioIO/seq_batch.h>
+#include <BioIO/fastq_reader.h>
+
+class ThreadPool;
+class ChunkPipeline;
+
+/**
+ * @brief Exception class for PairedFastqReader class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw PairedFastqReaderException(msg);
+ *
+ * @example
+ *   throw PairedFastqReaderException("Exception message");
+ */
+class PairedFastqReaderException : public std::exception {
+ public:
+  PairedFastqReaderException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  PairedFastqReaderException(const PairedFastqReaderException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
+
+/**
+ * @brief Reader of paired-end FASTQ files.
+ *
+ * The mates are read either from separate R1 and R2 files in lockstep, one
+ * batch of each at a time, or from a single interleaved file where each R1
+ * record is followed by its R2 record. In both cases the names of the mates
+ * are checked to match once any comment after whitespace and a trailing /1
+ * or /2 are removed.
+ *
+ * With prefetch the next batches of both files are parsed on two worker
+ * threads while the caller processes the current ones. Interleaved input is
+ * parsed like ParallelFastqReader does, in chunks cut between pairs, so the
+ * mates of a pair are never split between workers.
+ *
+ * @example
+ *   PairedFastqReader reader(file1, file2);
+ *   SeqBatch          batch1;
+ *   SeqBatch          batch2;
+ *
+ *   while (reader.NextBatch(batch1, batch2)) {
+ *     ...
+ *   }
+ *
+ * @example
+ *   PairedFastqReader reader(interleaved_file, threads);
+ */
+class PairedFastqReader
+{
+ public:
+  typedef std::pair<std::unique_ptr<SeqEntry>,
+                    std::unique_ptr<SeqEntry>> EntryPair;
+
+  /*
+   * Default number of pairs in each batch.
+   */
+  static const size_t kDefaultBatchSize = 4096;
+
+  /*
+   * Default size of the chunks of interleaved input parsed by each worker.
+   */
+  static const size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+  /*
+   * Read the mates from file1 and file2 in batches of batch_size pairs,
+   * parsing the next batches in the background if prefetch is set.
+   */
+  PairedFastqReader(const std::string &file1, const std::string &file2,
+                    const bool prefetch = true,
+                    const int encoding = FastqReader::kDefaultEncoding,
+                    const size_t batch_size = kDefaultBatchSize);
+
+  /*
+   * Read the pairs from the interleaved file on the given number of threads,
+   * or one per hardware thread if threads is 0, in chunks of about
+   * chunk_size chars. Batches hold the pairs of one chunk.
+   */
+  PairedFastqReader(const std::string &file, const size_t threads = 0,
+                    const int encoding = FastqReader::kDefaultEncoding,
+                    const size_t chunk_size = kDefaultChunkSize);
+
+  PairedFastqReader(const PairedFastqReader &) = delete;
+  PairedFastqReader &operator=(const PairedFastqReader &) = delete;
+
+  ~PairedFastqReader();
+
+  /*
+   * Replace the contents of batch1 and batch2 with the next mates from each
+   * file and return the number of pairs, which is 0 at end-of-file. Throws
+   * if the mate names differ or if one file ends before the other, or an
+   * interleaved file ends with an unpaired mate. Once thrown, the error is
+   * thrown again by every later call.
+   */
+  size_t NextBatch(SeqBatch &batch1, SeqBatch &batch2);
+
+  /*
+   * Return next pair of mates.
+   */
+  EntryPair NextEntry();
+
+  /*
+   * Tells if more pairs can be found.
+   */
+  bool HasNextEntry();
+
+  /*
+   * Return the part of a read name identifying the pair: the name up to the
+   * first whitespace without a trailing /1 or /2.
+   */
+  static CharSpan MateName(const CharSpan &name);
+
+ private:
+  /*
+   * Readers of the two files, or null for interleaved input.
+   */
+  std::unique_ptr<FastqReader> reader1_;
+  std::unique_ptr<FastqReader> reader2_;
+
+  /*
+   * Chunked interleaved input parsed on the worker threads, or null for two
+   * files.
+   */
+  std::unique_ptr<ChunkPipeline> pipeline_;
+
+  /*
+   * Number of pairs read at a time from two files.
+   */
+  const size_t batch_size_;
+
+  /*
+   * Number of pairs returned so far, for error messages.
+   */
+  uint64_t pairs_;
+
+  /*
+   * Prefetched batches and the futures telling when they are parsed.
+   */
+  SeqBatch            next1_;
+  SeqBatch            next2_;
+  std::future<size_t> done1_;
+  std::future<size_t> done2_;
+
+  /*
+   * Batches served by NextEntry and the index of their next pair.
+   */
+  SeqBatch current1_;
+  SeqBatch current2_;
+  size_t   current_pos_;
+
+  /*
+   * First error thrown by NextBatch, rethrown by every later call.
+   */
+  std::exception_ptr error_;
+
+  /*
+   * Workers parsing the prefetched batches, or null without prefetch.
+   * Declared last so it is joined before the batches and readers go away.
+   */
+  std::unique_ptr<ThreadPool> pool_;
+
+  /*
+   * Start parsing the next batches on the workers.
+   */
+  void Prefetch();
+
+  /*
+   * Read the next batches for NextBatch.
+   */
+  size_t ReadBatch(SeqBatch &batch1, SeqBatch &batch2);
+
+  /*
+   * Throw unless the n1 mates in batch1 pair up with the n2 in batch2. The
+   * names are compared from pair first on.
+   */
+  void CheckMates(const SeqBatch &batch1, const size_t n1,
+                  const SeqBatch &batch2, const size_t n2,
+                  const size_t first = 0);
+
+  /*
+   * Parse a chunk of interleaved records, sending the first mate of each
+   * pair to batch1 and the second to batch2. Parsing stops after the first
+   * pair whose names differ, so only the last pair is left for CheckMates,
+   * which knows its position in the input.
+   */
+  static void ParseInterleaved(const char *chunk, size_t size,
+                               SeqBatch &batch1, SeqBatch &batch2,
+                               const int encoding);
+};
+
+#endif  // BIOIO_PAIRED_FASTQ_READER_H_
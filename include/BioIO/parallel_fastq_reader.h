@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_PARALLEL_FASTQ_READER_H_
+#define BIOIO_PARALLEL_FASTQ_READER_H_
+
+#include <string>
+#include <memory>
+
+#include <BioIO/seq_entry.h>
+#include <BioIO/seq_batch.h>
+#include <BioIO/fastq_reader.h>
+
+class ChunkPipeline;
+
+/**
+ * @brief Multi-threaded FASTQ reader.
+ *
+ * The input is read in large chunks cut at verified record starts, and the
+ * chunks are parsed into SeqBatches on a pool of worker threads while the
+ * next chunks are read. Batches are delivered in file order, one per chunk.
+ * Parse errors are thrown as FastqReaderException from the call delivering
+ * the batch of the offending chunk.
+ *
+ * @example
+ *   ParallelFastqReader reader(file);
+ *   SeqBatch            batch;
+ *
+ *   while (reader.NextBatch(batch)) {
+ *     ...
+ *   }
+ */
+class ParallelFastqReader
+{
+ public:
+  /*
+   * Default size of the chunks parsed by each worker.
+   */
+  static const size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+  /*
+   * Parse file on the given number of threads, or one per hardware thread
+   * if threads is 0, in chunks of about chunk_size chars.
+   */
+  ParallelFastqReader(const std::string &file, const size_t threads = 0,
+                      const int encoding = FastqReader::kDefaultEncoding,
+                      const size_t chunk_size = kDefaultChunkSize);
+
+  ParallelFastqReader(const ParallelFastqReader &) = delete;
+  ParallelFastqReader &operator=(const ParallelFastqReader &) = delete;
+
+  ~ParallelFastqReader();
+
+  /*
+   * Replace the contents of batch with the records of the next chunk and
+   * return their number, which is 0 at end-of-file. The previous storage of
+   * batch is recycled by the workers.
+   */
+  size_t NextBatch(SeqBatch &batch);
+
+  /*
+   * Return next sequence entry.
+   */
+  std::unique_ptr<SeqEntry> NextEntry();
+
+  /*
+   * Tells if more sequence entries can be found.
+   */
+  bool HasNextEntry();
+
+ private:
+  /*
+   * Chunked input parsed on the worker threads.
+   */
+  std::unique_ptr<ChunkPipeline> pipeline_;
+
+  /*
+   * Batch served by NextEntry and the index of its next record.
+   */
+  SeqBatch current_;
+  size_t   current_pos_;
+};
+
+#endif  // BIOIO_PARALLEL_FASTQ_READER_H_
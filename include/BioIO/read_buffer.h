@@ -24,6 +24,12 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <cstdint>
+#include <memory>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 /**
  * @brief Exception class for ReadBuffer class.
@@ -50,10 +56,53 @@ class ReadBufferException : public std::exception {
   const std::string exceptionMsg;
 };
 
+class InputSource;
+
 class ReadBuffer
 {
  public:
-  ReadBuffer(const size_t size, const std::string &file);
+  /*
+   * Input backends. In automatic mode regular files are memory mapped and
+   * parsed straight out of the page cache, while anything that cannot be
+   * mapped falls back to the asynchronous stream. Requesting mmap explicitly
+   * throws if the file cannot be mapped. Pipes, FIFOs and standard input are
+   * always streamed until end-of-file, so their size need not be known.
+   * Compressed files are recognised by their magic bytes and decompressed
+   * while streaming; in automatic mode decompression runs on the read-ahead
+   * thread, so inflating and parsing overlap. BGZF files are in addition
+   * inflated block by block on a pool of threads.
+   *
+   * The stream is read synchronously, while async reads ahead into a second
+   * buffer on a background thread so I/O overlaps with parsing. If the thread
+   * cannot be started, async falls back to reading synchronously.
+   */
+  enum class Mode {
+    automatic,
+    mmap,
+    stream,
+    async
+  };
+
+  /*
+   * File name used to read from standard input.
+   */
+  static const std::string kStdin;
+
+  /*
+   * Read file in chunks of size chars. Parallel decompression of the input
+   * uses the given number of threads, or one per hardware thread if threads
+   * is 0.
+   */
+  ReadBuffer(const size_t size, const std::string &file,
+             const Mode mode = Mode::automatic, const size_t threads = 0);
+
+  /*
+   * Read size chars of data in memory, which must outlive the ReadBuffer.
+   */
+  ReadBuffer(const char *data, const size_t size);
+
+  ReadBuffer(const ReadBuffer &) = delete;
+  ReadBuffer &operator=(const ReadBuffer &) = delete;
 
   ~ReadBuffer();
 
@@ -77,6 +126,71 @@ class ReadBuffer
    */
   bool Eof();
 
+  /*
+   * Return a pointer to the unread chars in the buffer and store their
+   * number in len, loading the next buffer first if all chars are read.
+   * Returns nullptr at end-of-file.
+   */
+  const char *Peek(size_t &len);
+
+  /*
+   * Advance the read position len chars, which must not exceed the number
+   * of chars returned by Peek or LineSpan.
+   */
+  void Skip(size_t len);
+
+  /*
+   * Return a pointer to the unread chars in the buffer up to the next line
+   * end and store their number in len. eol tells if the span ends at a line
+   * end or else at the end of the buffer, in which case the caller should
+   * Skip the span and call again. The line end is located with vectorised
+   * scanning. Returns nullptr at end-of-file.
+   */
+  const char *LineSpan(size_t &len, bool &eol);
+
+  /*
+   * Consume the line end at the read position, that is \n, \r or \r\n.
+   */
+  void SkipEol();
+
+  /*
+   * Continue reading at the given byte offset. Only memory mapped, in-memory
+   * and uncompressed files can seek; other input throws.
+   */
+  void Seek(uint64_t offset);
+
+  /*
+   * Return true if the file is memory mapped.
+   */
+  bool mapped() const;
+
+  /*
+   * Return true if the input is read ahead on a background thread.
+   */
+  bool async() const;
+
+  /*
+   * Return true if the input is decompressed while being read.
+   */
+  bool compressed() const;
+
+  /*
+   * Return the number of threads decompressing the input besides the one
+   * reading it, which is 0 unless the codec decompresses in parallel.
+   */
+  size_t decompress_threads() const;
+
+  /*
+   * Return the absolute byte offset of the next char to be read.
+   */
+  uint64_t Offset() const;
+
+  /*
+   * Return the size of the input in bytes or 0 if the size is unknown, as is
+   * the case for pipes, standard input and compressed files.
+   */
+  uint64_t Size() const;
+
  private:
 
   /*
@@ -85,34 +199,133 @@ class ReadBuffer
   const size_t buffer_size_;
 
   /*
-   * Input stream of file being read.
+   * Source of the input when streaming or nullptr if the file is mapped.
    */
-  std::ifstream input_stream_;
+  std::unique_ptr<InputSource> source_;
+
+  /*
+   * Tells if source_ decompresses the input.
+   */
+  bool compressed_;
 
   /*
    * Read buffer.
    */
   char *buffer_;
 
+  /*
+   * Memory mapped file or nullptr if the file is read through the stream.
+   */
+  void *map_;
+
+  /*
+   * Size of the memory mapped region.
+   */
+  size_t map_size_;
+
+  /*
+   * Data being read, that is either the read buffer or the mapped file.
+   */
+  const char *data_;
+
+  /*
+   * Number of valid chars in data_.
+   */
+  size_t data_size_;
+
   /*
    * Current position in buffer being read.
    */
   size_t buffer_pos_;
 
   /*
-   * Size of file being read.
+   * Absolute byte offset of the first char in data_.
+   */
+  uint64_t buffer_offset_;
+
+  /*
+   * Size of the input in bytes or 0 if unknown.
+   */
+  uint64_t input_size_;
+
+  /*
+   * Buffer filled by the read-ahead thread while buffer_ is being parsed.
+   */
+  char *back_buffer_;
+
+  /*
+   * Number of chars read into back_buffer_.
+   */
+  size_t back_size_;
+
+  /*
+   * Tells if back_buffer_ is filled and ready to be swapped in.
+   */
+  bool back_ready_;
+
+  /*
+   * Exception thrown by the read-ahead thread while reading the input.
+   */
+  std::exception_ptr back_error_;
+
+  /*
+   * Tells the read-ahead thread to stop.
+   */
+  bool stop_;
+
+  /*
+   * Read-ahead thread and the mutex and condition guarding the back buffer.
+   */
+  std::thread read_ahead_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  /*
+   * Get the size of a regular file and store in input_size_.
+   */
+  void GetInputSize(const std::string &file);
+
+  /*
+   * Memory map the file and return true on success.
+   */
+  bool MapFile(const std::string &file);
+
+  /*
+   * Unmap a memory mapped file.
+   */
+  void UnmapFile();
+
+  /*
+   * Open the file as a buffered input stream.
+   */
+  void OpenStream(const std::string &file, const size_t threads);
+
+  /*
+   * Start the read-ahead thread. Returns false if no thread could be started.
+   */
+  bool StartReadAhead();
+
+  /*
+   * Stop and join the read-ahead thread.
+   */
+  void StopReadAhead();
+
+  /*
+   * Body of the read-ahead thread filling back_buffer_ until end-of-file.
    */
-  int file_size_;
+  void ReadAhead();
 
   /*
-   * Get the file size from the istream and store in file_size_.
+   * Read up to buffer_size_ chars from the input source into dst and return
+   * the number of chars read.
    */
-  void GetFileSize();
+  size_t ReadInput(char *dst);
 
   /*
-   * Read data from the input stream into the buffer.
+   * Read data from the input stream into the buffer. Returns false when
+   * end-of-file is reached and no more data could be read.
    */
-  void LoadBuffer();
+  bool LoadBuffer();
 };
 
 #endif  // BIOIO_READ_BUFFER_H_
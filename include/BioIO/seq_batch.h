@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_SEQ_BATCH_H_
+#define BIOIO_SEQ_BATCH_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <BioIO/seq_entry.h>
+#include <BioIO/seq_view.h>
+
+/**
+ * @brief Batch of sequence records stored as structure of arrays.
+ *
+ * The names, sequences and scores of all records are kept back to back in
+ * three contiguous arenas, and record i spans [offsets[i], offsets[i + 1])
+ * of each arena. Clearing a batch keeps the capacity of the arenas, so a
+ * batch reused across reads stops allocating once it has grown to the size
+ * of the largest batch.
+ *
+ * @example
+ *   SeqBatch batch;
+ *
+ *   while (reader.NextBatch(batch, 4096)) {
+ *     for (size_t i = 0; i < batch.size(); ++i)
+ *       Process(batch.name(i), batch.seq(i));
+ *   }
+ */
+class SeqBatch
+{
+ public:
+  SeqBatch();
+
+  /*
+   * Return the number of records in the batch.
+   */
+  size_t size() const;
+
+  /*
+   * Return true if the batch holds no records.
+   */
+  bool empty() const;
+
+  /*
+   * Remove all records, keeping the capacity of the arenas.
+   */
+  void clear();
+
+  /*
+   * Reserve room for records records with a total of chars name chars and
+   * bases sequence chars and scores.
+   */
+  void reserve(size_t records, size_t chars, size_t bases);
+
+  /*
+   * Append a record with the given name and sequence and return a pointer
+   * to room for its scores_size scores, which the caller must fill. The
+   * pointer is valid until the next change to the batch.
+   */
+  uint8_t *Append(const CharSpan &name, const CharSpan &seq,
+                  const size_t scores_size = 0);
+
+  /*
+   * Return the name of record i.
+   */
+  CharSpan name(const size_t i) const;
+
+  /*
+   * Return the sequence of record i.
+   */
+  CharSpan seq(const size_t i) const;
+
+  /*
+   * Return a pointer to the scores of record i and store their number in
+   * len, which is 0 for records without scores.
+   */
+  const uint8_t *scores(const size_t i, size_t &len) const;
+
+  /*
+   * Return a copy of record i.
+   */
+  SeqEntry Entry(const size_t i) const;
+
+  /*
+   * Return or set the type of the sequences, which is given to the entries
+   * from Entry. Defaults to nucleotide and is kept by clear.
+   */
+  SeqEntry::SeqType type() const;
+  void set_type(const SeqEntry::SeqType type);
+
+  /*
+   * Return the arenas holding the names, sequences and scores of all records
+   * back to back.
+   */
+  const std::string &names() const;
+  const std::string &seqs() const;
+  const std::vector<uint8_t> &all_scores() const;
+
+  /*
+   * Return the size() + 1 offsets of the records into the arenas.
+   */
+  const std::vector<size_t> &name_offsets() const;
+  const std::vector<size_t> &seq_offsets() const;
+  const std::vector<size_t> &score_offsets() const;
+
+ private:
+  std::string          names_;
+  std::string          seqs_;
+  std::vector<uint8_t> scores_;
+
+  std::vector<size_t> name_offsets_;
+  std::vector<size_t> seq_offsets_;
+  std::vector<size_t> score_offsets_;
+
+  SeqEntry::SeqType type_;
+};
+
+#endif  // BIOIO_SEQ_BATCH_H_
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_SEQ_CHUNK_H_
+#define BIOIO_SEQ_CHUNK_H_
+
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Window of a sequence record read a chunk at a time.
+ *
+ * Long records, such as whole chromosomes, are delivered as consecutive
+ * chunks of at most a fixed number of bases, so only one chunk of the
+ * record is in memory at a time. Consecutive chunks of a record share
+ * overlap bases, so every window of up to overlap + 1 bases is found whole
+ * in one chunk.
+ *
+ * @example
+ *   SeqChunk chunk;
+ *
+ *   while (reader.NextChunk(chunk, 1 << 20, k - 1)) {
+ *     CountKmers(chunk.name, chunk.offset, chunk.seq, k);
+ *   }
+ */
+struct SeqChunk {
+  /*
+   * Name of the record.
+   */
+  std::string name;
+
+  /*
+   * Bases of the chunk.
+   */
+  std::string seq;
+
+  /*
+   * Position of the first base of the chunk in the record, counted from 0.
+   */
+  uint64_t offset;
+
+  /*
+   * True for the last chunk of the record.
+   */
+  bool last;
+
+  SeqChunk() :
+    name(),
+    seq(),
+    offset(0),
+    last(true)
+  {}
+};
+
+#endif  // BIOIO_SEQ_CHUNK_H_
@@ -23,7 +23,36 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <ostream>
+#include <exception>
+
+#include <BioIO/packed_seq.h>
+
+/**
+ * @brief Exception class for SeqEntry class.
+ *
+ * @example
+ *   std::string msg = "Exception message";
+ *   throw SeqEntryException(msg);
+ *
+ * @example
+ *   throw SeqEntryException("Exception message");
+ */
+class SeqEntryException : public std::exception {
+ public:
+  SeqEntryException(std::string &msg) :
+    exceptionMsg(msg)
+  {}
+
+  SeqEntryException(const SeqEntryException &e) :
+    exceptionMsg(e.exceptionMsg)
+  {}
+
+  virtual const char* what() const throw() { return exceptionMsg.c_str(); }
+
+  const std::string exceptionMsg;
+};
 
 /**
  * // TODO
@@ -61,7 +90,7 @@ class SeqEntry {
     /**
      * Move constructor.
      */
-    SeqEntry(SeqEntry&& other);
+    SeqEntry(SeqEntry&& other) noexcept;
 
     virtual ~SeqEntry();
 
@@ -78,10 +107,29 @@ class SeqEntry {
     SeqEntry SubSeq(size_t i, size_t len) const;
 
     /**
-     * Returns the size of the sequence.
+     * Returns the size of the sequence, packed or not.
      */
     size_t Size();
 
+    /**
+     * Pack a nucleotide sequence at 2 bits per base, see PackedSeq. The
+     * sequence is moved to packed_seq() and seq() is left empty. Packing is
+     * lossy, as bases other than ACGT unpack as N, and throws for sequence
+     * types other than nucleotide.
+     */
+    void Pack();
+
+    /**
+     * Move a packed sequence back to seq().
+     */
+    void Unpack();
+
+    /**
+     * @return True if the sequence is held in packed_seq(). An empty
+     * sequence counts as unpacked.
+     */
+    bool packed() const;
+
     /**
      * Reverse sequence and scores.
      */
@@ -98,25 +146,44 @@ class SeqEntry {
     const std::string& name() const;
 
     /**
-     * @return Reference to sequence
+     * @return Reference to sequence, which is empty while the sequence is
+     * packed until Unpack() is called
      */
     std::string& seq();
 
     /**
-     * @return Reference to const sequence
+     * @return Reference to const sequence, which is empty while packed
      */
     const std::string& seq() const;
 
     /**
-     * @return Reference to vector of scores
+     * @return Reference to packed sequence
+     */
+    PackedSeq& packed_seq();
+
+    /**
+     * @return Reference to const packed sequence
+     */
+    const PackedSeq& packed_seq() const;
+
+    /**
+     * @return Reference to vector of scores, decoding raw scores first
      */
     std::vector<uint8_t>& scores();
 
     /**
-     * @return Reference to const vector of scores
+     * @return Reference to const vector of scores, decoding raw scores
+     * first. Decoding changes the entry, so do not call this on one entry
+     * from several threads before the scores are decoded.
      */
     const std::vector<uint8_t>& scores() const;
 
+    /**
+     * @return Reference to const raw scores not yet decoded, which are
+     * empty once decoded
+     */
+    const std::string& raw_scores() const;
+
     /**
      * @return Reference to sequence type
      */
@@ -132,11 +199,29 @@ class SeqEntry {
      */
     void set_seq(const std::string& sequence);
 
+    /**
+     * Pack a sequence like Pack(), which throws unless the type is
+     * nucleotide.
+     * @param Sequence to pack
+     * @param Length of sequence
+     */
+    void set_packed_seq(const char* sequence, size_t size);
+
     /**
      * @param Sequence scores
      */
     void set_scores(const std::vector<uint8_t>& scores);
 
+    /**
+     * Keep FASTQ encoded scores as they are and decode them on the first
+     * call to scores(), which throws if a score char is below the encoding
+     * or above 126.
+     * @param Encoded scores
+     * @param Number of scores
+     * @param Score encoding
+     */
+    void set_raw_scores(const char* scores, size_t size, uint8_t encoding);
+
     /**
      * @param Sequence type
      */
@@ -150,8 +235,21 @@ class SeqEntry {
   private:
     std::string name_;
     std::string seq_;
-    std::vector<uint8_t> scores_;
+    PackedSeq packed_seq_;
+    mutable std::vector<uint8_t> scores_;
+    mutable std::string raw_scores_;
+    uint8_t score_encoding_;
     SeqType type_;
+
+    /**
+     * Decode raw_scores_ into scores_.
+     */
+    void DecodeScores() const;
+
+    /**
+     * Throw unless the sequence type can be packed.
+     */
+    void CheckPackable() const;
 };
 
 #endif // BIOIO_SEQ_ENTRY_H_
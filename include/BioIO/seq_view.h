@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_SEQ_VIEW_H_
+#define BIOIO_SEQ_VIEW_H_
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief Non-owning view of a run of chars.
+ */
+struct CharSpan {
+  const char *data;
+  size_t      size;
+
+  CharSpan() :
+    data(nullptr),
+    size(0)
+  {}
+
+  CharSpan(const char *data, const size_t size) :
+    data(data),
+    size(size)
+  {}
+
+  bool empty() const { return size == 0; }
+
+  const char *begin() const { return data; }
+
+  const char *end() const { return data + size; }
+
+  char operator[](const size_t i) const { return data[i]; }
+
+  /*
+   * Return a copy of the viewed chars.
+   */
+  std::string str() const { return std::string(data, size); }
+};
+
+/**
+ * @brief Zero-copy view of a sequence record.
+ *
+ * The views point straight into the reader's input buffer or, for memory
+ * mapped files, into the mapping. Only records that straddle a buffer
+ * boundary or whose sequence spans several lines are collected in the
+ * reader's scratch buffers. Either way nothing is allocated per record and
+ * the views stay valid until the next call to the reader.
+ *
+ * @example
+ *   while (reader.HasNextEntry()) {
+ *     SeqView view = reader.NextView();
+ *
+ *     if (view.seq.size >= min_length)
+ *       entries.push_back(view.seq.str());
+ *   }
+ */
+struct SeqView {
+  /*
+   * Name of sequence.
+   */
+  CharSpan name;
+
+  /*
+   * Sequence without line ends.
+   */
+  CharSpan seq;
+
+  /*
+   * Encoded quality scores as found in the file. Empty for FASTA records.
+   */
+  CharSpan scores;
+};
+
+#endif  // BIOIO_SEQ_VIEW_H_
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_SIMD_H_
+#define BIOIO_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Vectorised scanning kernels with runtime CPU dispatch.
+ *
+ * Each kernel has a scalar, an SSE2 and an AVX2 implementation, and some
+ * also an AVX-512BW one; the others use their AVX2 implementation at that
+ * level. The best implementation supported by the CPU is selected on first
+ * use.
+ *
+ * @example
+ *   const char *eol = Simd::FindEol(line, line + len);
+ */
+class Simd
+{
+ public:
+  /*
+   * Instruction set levels in increasing order.
+   */
+  enum class Level {
+    scalar,
+    sse2,
+    avx2,
+    avx512bw
+  };
+
+  /*
+   * Return the level used by the kernels.
+   */
+  static Level level();
+
+  /*
+   * Return the highest level supported by the CPU.
+   */
+  static Level MaxLevel();
+
+  /*
+   * Use the given level, capped at MaxLevel(), for all following calls.
+   * Meant for testing and benchmarking; not thread safe.
+   */
+  static void set_level(Level level);
+
+  /*
+   * Return a pointer to the first \n or \r in [begin, end) or end if there
+   * is none.
+   */
+  static const char *FindEol(const char *begin, const char *end);
+
+  /*
+   * Return a pointer to the first char in [begin, end) that is not a
+   * printable non-whitespace char, i.e. outside 33-126, or end if there is
+   * none.
+   */
+  static const char *FindNonSeq(const char *begin, const char *end);
+
+  /*
+   * Pack size bases at 2 bits per base into words, 32 bases per word from
+   * the low bits, with A, C, G and T in either case as 0-3. Other chars are
+   * packed as 0 and flagged by their bit in mask, 64 bases per word. The
+   * (size + 31) / 32 words and (size + 63) / 64 mask words are overwritten,
+   * with the bits past size cleared.
+   */
+  static void Pack2Bit(const char *seq, size_t size, uint64_t *words,
+                       uint64_t *mask);
+
+  /*
+   * Unpack size bases packed by Pack2Bit into seq as upper case ACGT, with
+   * the bases flagged in mask as N. mask may be null if no bases are
+   * flagged.
+   */
+  static void Unpack2Bit(const uint64_t *words, const uint64_t *mask,
+                         size_t size, char *seq);
+
+  /*
+   * Subtract offset from the size encoded scores in src and write them to
+   * scores. Returns false if any encoded score is outside offset-126, in
+   * which case scores are only partly written.
+   */
+  static bool DecodeScores(const char *src, size_t size, uint8_t offset,
+                           uint8_t *scores);
+
+  /*
+   * Lower min and raise max to cover the chars in [begin, end) as unsigned
+   * values.
+   */
+  static void MinMax(const char *begin, const char *end, uint8_t &min,
+                     uint8_t &max);
+};
+
+#endif  // BIOIO_SIMD_H_
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/bgzf_index.h>
+
+#include <fstream>
+#include <algorithm>
+
+#include "byte_order.h"
+#include "input_source.h"
+
+BgzfIndex::BgzfIndex() :
+  blocks_(1, BgzfBlock{0, 0})
+{}
+
+BgzfIndex BgzfIndex::Build(const std::string &file) {
+  StreamSource source(file);
+  BgzfIndex    index;
+  std::string  block;
+  BgzfBlock    next = {0, 0};
+
+  index.blocks_.clear();
+
+  while (BgzfSource::ReadBlock(source, block)) {
+    const unsigned char *trailer =
+      reinterpret_cast<const unsigned char *>(block.data()) + block.size() - 4;
+    uint64_t size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) |
+                    (static_cast<uint64_t>(trailer[3]) << 24);
+
+    // Empty blocks, such as the end-of-file marker, start no data.
+    if (size > 0 || index.blocks_.empty()) {
+      index.blocks_.push_back(next);
+    }
+
+    next.compressed_offset   += block.size();
+    next.uncompressed_offset += size;
+  }
+
+  if (index.blocks_.empty()) {
+    index.blocks_.push_back(BgzfBlock{0, 0});
+  }
+
+  return index;
+}
+
+BgzfIndex BgzfIndex::Load(const std::string &file) {
+  std::ifstream input(file, std::ifstream::in | std::ifstream::binary);
+
+  if (!input) {
+    std::string msg = "Error: File not found or not readable: " + file;
+    throw BgzfIndexException(msg);
+  }
+
+  BgzfIndex index;
+  uint64_t  count;
+
+  if (!ReadUint64(input, count)) {
+    std::string msg = "Error: malformed BGZF index file: " + file;
+    throw BgzfIndexException(msg);
+  }
+
+  for (uint64_t i = 0; i < count; ++i) {
+    BgzfBlock block;
+
+    if (!ReadUint64(input, block.compressed_offset) ||
+        !ReadUint64(input, block.uncompressed_offset) ||
+        block.compressed_offset <= index.blocks_.back().compressed_offset ||
+        block.uncompressed_offset < index.blocks_.back().uncompressed_offset) {
+      std::string msg = "Error: malformed BGZF index file: " + file;
+      throw BgzfIndexException(msg);
+    }
+
+    index.blocks_.push_back(block);
+  }
+
+  return index;
+}
+
+void BgzfIndex::Save(const std::string &file) const {
+  std::ofstream output(file, std::ofstream::out | std::ofstream::binary);
+
+  // The first block is implied.
+  WriteUint64(output, blocks_.size() - 1);
+
+  for (size_t i = 1; i < blocks_.size(); ++i) {
+    WriteUint64(output, blocks_[i].compressed_offset);
+    WriteUint64(output, blocks_[i].uncompressed_offset);
+  }
+
+  output.close();
+
+  if (!output) {
+    std::string msg = "Error: could not write BGZF index: " + file;
+    throw BgzfIndexException(msg);
+  }
+}
+
+size_t BgzfIndex::size() const {
+  return blocks_.size();
+}
+
+const std::vector<BgzfBlock> &BgzfIndex::blocks() const {
+  return blocks_;
+}
+
+const BgzfBlock &BgzfIndex::Locate(uint64_t offset) const {
+  auto it = std::upper_bound(blocks_.begin(), blocks_.end(), offset,
+                             [](uint64_t pos, const BgzfBlock &block) {
+                               return pos < block.uncompressed_offset;
+                             });
+
+  return *(it - 1);
+}
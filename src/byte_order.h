@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_BYTE_ORDER_H_
+#define BIOIO_BYTE_ORDER_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+/*
+ * Read a little-endian 64-bit integer into value. Returns false at
+ * end-of-file.
+ */
+inline bool ReadUint64(std::istream &input, uint64_t &value) {
+  unsigned char bytes[8];
+
+  if (!input.read(reinterpret_cast<char *>(bytes), sizeof(bytes))) {
+    return false;
+  }
+
+  value = 0;
+
+  for (size_t i = sizeof(bytes); i-- > 0; ) {
+    value = (value << 8) | bytes[i];
+  }
+
+  return true;
+}
+
+/*
+ * Write value as a little-endian 64-bit integer.
+ */
+inline void WriteUint64(std::ostream &output, uint64_t value) {
+  char bytes[8];
+
+  for (size_t i = 0; i < sizeof(bytes); ++i) {
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  }
+
+  output.write(bytes, sizeof(bytes));
+}
+
+#endif  // BIOIO_BYTE_ORDER_H_
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "chunk_pipeline.h"
+
+#include <chrono>
+#include <algorithm>
+#include <utility>
+
+ChunkPipeline::ChunkPipeline(const std::string &file, const size_t threads,
+                             const size_t chunk_size,
+                             const ChunkReader::CutFunc cut,
+                             const ParseFunc &parse, const bool ordered) :
+  ChunkPipeline(file, threads, chunk_size, cut,
+                [parse](const char *chunk, size_t size, SeqBatch &batch,
+                        SeqBatch &) {
+                  parse(chunk, size, batch);
+                },
+                ordered)
+{}
+
+ChunkPipeline::ChunkPipeline(const std::string &file, const size_t threads,
+                             const size_t chunk_size,
+                             const ChunkReader::CutFunc cut,
+                             const PairParseFunc &parse, const bool ordered) :
+  chunks_(file, chunk_size, cut, DecompressThreads(threads)),
+  parse_(parse),
+  ordered_(ordered),
+  eof_(false),
+  pending_(),
+  free_(),
+  max_pending_(0),
+  pool_(ParseThreads(threads, chunks_.decompress_threads()))
+{
+  // Keep every worker busy while the next chunks are being read.
+  max_pending_ = 2 * pool_.size();
+}
+
+ChunkPipeline::~ChunkPipeline()
+{}
+
+size_t ChunkPipeline::DecompressThreads(const size_t threads) {
+  size_t total = threads ? threads : ThreadPool::DefaultThreads();
+
+  return std::max<size_t>(1, total / 4);
+}
+
+size_t ChunkPipeline::ParseThreads(const size_t threads,
+                                   const size_t decompress_threads) {
+  size_t total = threads ? threads : ThreadPool::DefaultThreads();
+
+  if (decompress_threads >= total) {
+    return 1;
+  }
+
+  return total - decompress_threads;
+}
+
+size_t ChunkPipeline::NextBatch(SeqBatch &batch) {
+  return Deliver(batch, nullptr);
+}
+
+size_t ChunkPipeline::NextBatch(SeqBatch &batch1, SeqBatch &batch2) {
+  return Deliver(batch1, &batch2);
+}
+
+size_t ChunkPipeline::Deliver(SeqBatch &batch, SeqBatch *mates) {
+  batch.clear();
+
+  if (mates) {
+    mates->clear();
+  }
+
+  while (batch.empty()) {
+    Submit();
+
+    if (pending_.empty()) {
+      return 0;
+    }
+
+    std::unique_ptr<Task> task = NextTask();
+
+    task->done.get();
+
+    std::swap(batch, task->batch);
+
+    if (mates) {
+      std::swap(*mates, task->mates);
+    }
+
+    free_.push_back(std::move(task));
+  }
+
+  return batch.size();
+}
+
+void ChunkPipeline::Submit() {
+  while (!eof_ && pending_.size() < max_pending_) {
+    std::unique_ptr<Task> task;
+
+    if (free_.empty()) {
+      task.reset(new Task());
+    } else {
+      task = std::move(free_.back());
+      free_.pop_back();
+    }
+
+    if (!chunks_.NextChunk(task->storage, task->chunk, task->size)) {
+      eof_ = true;
+      free_.push_back(std::move(task));
+      break;
+    }
+
+    Task                *raw   = task.get();
+    const PairParseFunc &parse = parse_;
+
+    task->done = pool_.Submit([raw, &parse] {
+      parse(raw->chunk, raw->size, raw->batch, raw->mates);
+    });
+
+    pending_.push_back(std::move(task));
+  }
+}
+
+std::unique_ptr<ChunkPipeline::Task> ChunkPipeline::NextTask() {
+  auto next = pending_.begin();
+
+  if (!ordered_) {
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+      if ((*it)->done.wait_for(std::chrono::seconds(0)) ==
+          std::future_status::ready) {
+        next = it;
+        break;
+      }
+    }
+  }
+
+  std::unique_ptr<Task> task = std::move(*next);
+  pending_.erase(next);
+
+  return task;
+}
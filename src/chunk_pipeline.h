@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_CHUNK_PIPELINE_H_
+#define BIOIO_CHUNK_PIPELINE_H_
+
+#include <deque>
+#include <string>
+#include <memory>
+#include <vector>
+#include <future>
+#include <functional>
+
+#include <BioIO/seq_batch.h>
+
+#include "chunk_reader.h"
+#include "thread_pool.h"
+
+/*
+ * Parses the chunks of a ChunkReader into SeqBatches on a pool of worker
+ * threads while the next chunks are read. Chunks and batches are recycled
+ * between tasks, so a pipeline running at steady state does not allocate.
+ */
+class ChunkPipeline
+{
+ public:
+  /*
+   * Function parsing a chunk of size chars into batch.
+   */
+  typedef std::function<void(const char *chunk, size_t size,
+                             SeqBatch &batch)> ParseFunc;
+
+  /*
+   * Function parsing a chunk of size chars of paired records into one batch
+   * per mate.
+   */
+  typedef std::function<void(const char *chunk, size_t size,
+                             SeqBatch &batch1, SeqBatch &batch2)> PairParseFunc;
+
+  /*
+   * Parse file on the given number of threads, or one per hardware thread
+   * if threads is 0, in chunks of about chunk_size chars cut by cut. If
+   * ordered is false, batches are delivered as soon as they are parsed
+   * rather than in file order.
+   *
+   * Codecs that decompress in parallel, BGZF, zstd and xz, get a quarter
+   * of the threads, at least one, and the input is parsed on the rest, so
+   * the two pools together stay within the thread count. Other input is
+   * parsed on all of them.
+   */
+  ChunkPipeline(const std::string &file, const size_t threads,
+                const size_t chunk_size, const ChunkReader::CutFunc cut,
+                const ParseFunc &parse, const bool ordered);
+  ChunkPipeline(const std::string &file, const size_t threads,
+                const size_t chunk_size, const ChunkReader::CutFunc cut,
+                const PairParseFunc &parse, const bool ordered);
+
+  ChunkPipeline(const ChunkPipeline &) = delete;
+  ChunkPipeline &operator=(const ChunkPipeline &) = delete;
+
+  ~ChunkPipeline();
+
+  /*
+   * Replace the contents of batch with the records of the next chunk and
+   * return their number, which is 0 at end-of-file. Exceptions thrown by
+   * the parse function are rethrown here.
+   */
+  size_t NextBatch(SeqBatch &batch);
+
+  /*
+   * Replace the contents of batch1 and batch2 with the mates of the next
+   * chunk parsed by a PairParseFunc and return the number of pairs.
+   */
+  size_t NextBatch(SeqBatch &batch1, SeqBatch &batch2);
+
+ private:
+  /*
+   * A chunk, the storage it may be copied into, and the batches it is parsed
+   * into. Only paired records use the mates batch.
+   */
+  struct Task {
+    std::string       storage;
+    const char       *chunk;
+    size_t            size;
+    SeqBatch          batch;
+    SeqBatch          mates;
+    std::future<void> done;
+  };
+
+  /*
+   * Source of the chunks.
+   */
+  ChunkReader chunks_;
+
+  /*
+   * Function parsing the chunks.
+   */
+  const PairParseFunc parse_;
+
+  /*
+   * Tells if batches are delivered in file order.
+   */
+  const bool ordered_;
+
+  /*
+   * Tells if the last chunk has been read.
+   */
+  bool eof_;
+
+  /*
+   * Tasks submitted to the workers in file order, and finished tasks kept
+   * for reuse.
+   */
+  std::deque<std::unique_ptr<Task>> pending_;
+  std::vector<std::unique_ptr<Task>> free_;
+
+  /*
+   * Maximum number of tasks in flight.
+   */
+  size_t max_pending_;
+
+  /*
+   * Worker threads. Declared last, so the workers are joined before the
+   * tasks they work on are destroyed.
+   */
+  ThreadPool pool_;
+
+  /*
+   * Return the number of threads, resolving 0 to one per hardware thread,
+   * that decompress the input.
+   */
+  static size_t DecompressThreads(const size_t threads);
+
+  /*
+   * Return the number of threads, resolving 0 to one per hardware thread,
+   * that parse the chunks of input decompressed on decompress_threads.
+   */
+  static size_t ParseThreads(const size_t threads,
+                             const size_t decompress_threads);
+
+  /*
+   * Submit chunks to the workers until max_pending_ are in flight or the
+   * input is exhausted.
+   */
+  void Submit();
+
+  /*
+   * Remove and return the next task to deliver, which is the oldest unless
+   * delivery is unordered and a newer task is already done.
+   */
+  std::unique_ptr<Task> NextTask();
+
+  /*
+   * Swap the batches of the next non-empty chunk into batch and, unless
+   * null, mates, and return the number of records in batch.
+   */
+  size_t Deliver(SeqBatch &batch, SeqBatch *mates);
+};
+
+#endif  // BIOIO_CHUNK_PIPELINE_H_
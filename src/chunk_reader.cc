@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "chunk_reader.h"
+
+#include <cstring>
+#include <algorithm>
+
+ChunkReader::ChunkReader(const std::string &file, const size_t chunk_size,
+                         const CutFunc cut, const size_t threads) :
+  read_buffer_(kBufferSize, file, ReadBuffer::Mode::automatic, threads),
+  chunk_size_(chunk_size),
+  cut_(cut),
+  carry_()
+{}
+
+bool ChunkReader::NextChunk(std::string &storage, const char *&data,
+                            size_t &size) {
+  if (read_buffer_.mapped()) {
+    return NextMappedChunk(data, size);
+  }
+
+  if (!NextCopiedChunk(storage)) {
+    return false;
+  }
+
+  data = storage.data();
+  size = storage.size();
+
+  return true;
+}
+
+size_t ChunkReader::decompress_threads() const {
+  return read_buffer_.decompress_threads();
+}
+
+bool ChunkReader::NextMappedChunk(const char *&data, size_t &size) {
+  size_t      len;
+  const char *span = read_buffer_.Peek(len);
+
+  if (!span) {
+    return false;
+  }
+
+  size_t target = chunk_size_;
+  size_t cut    = 0;
+
+  // The whole rest of the file is mapped, so grow the chunk until a record
+  // start is found or the rest of the file is taken.
+  while (target < len && (cut = cut_(span, target)) == 0) {
+    target *= 2;
+  }
+
+  data = span;
+  size = (cut > 0) ? cut : len;
+
+  read_buffer_.Skip(size);
+
+  return true;
+}
+
+bool ChunkReader::NextCopiedChunk(std::string &chunk) {
+  size_t target = chunk_size_;
+
+  chunk.assign(carry_);
+  carry_.clear();
+
+  while (true) {
+    size_t      len;
+    const char *span;
+
+    while (chunk.size() < target && (span = read_buffer_.Peek(len))) {
+      len = std::min(len, target - chunk.size());
+
+      chunk.append(span, len);
+      read_buffer_.Skip(len);
+    }
+
+    if (chunk.size() < target) {
+      break;
+    }
+
+    size_t cut = cut_(chunk.data(), chunk.size());
+
+    if (cut > 0) {
+      carry_.assign(chunk, cut, std::string::npos);
+      chunk.resize(cut);
+
+      return true;
+    }
+
+    // No record start was found, so the chunk holds part of a record larger
+    // than the chunk size.
+    target *= 2;
+  }
+
+  return !chunk.empty();
+}
+
+namespace {
+
+/*
+ * A line in a chunk without its line end.
+ */
+struct Line {
+  const char *begin;
+  size_t      size;
+};
+
+/*
+ * Store the last count complete lines of data in lines in file order and
+ * return the number found.
+ */
+size_t LastLines(const char *data, const size_t size, Line *lines,
+                 const size_t count) {
+  const char *pos = data + size;
+  size_t      n   = 0;
+
+  // Skip the incomplete line at the end.
+  while (pos > data && pos[-1] != '\n') {
+    --pos;
+  }
+
+  while (pos > data && n < count) {
+    const char *eol   = pos - 1;
+    const char *begin = eol;
+
+    while (begin > data && begin[-1] != '\n') {
+      --begin;
+    }
+
+    if (eol > begin && eol[-1] == '\r') {
+      --eol;
+    }
+
+    lines[count - ++n] = Line{begin, static_cast<size_t>(eol - begin)};
+    pos = begin;
+  }
+
+  std::memmove(lines, lines + count - n, n * sizeof(Line));
+
+  return n;
+}
+
+/*
+ * Tell if the four lines from record form a FASTQ record: a line starting
+ * with '@', a sequence line, a line starting with '+' and a quality line of
+ * the same length as the sequence.
+ */
+bool IsFastqRecord(const Line *record) {
+  return record[0].size > 0 && record[0].begin[0] == '@' &&
+         record[2].size > 0 && record[2].begin[0] == '+' &&
+         record[1].size == record[3].size;
+}
+
+/*
+ * Tell if the header lines header1 and header2 name mates of the same pair.
+ */
+bool IsMate(const Line &header1, const Line &header2) {
+  return MatesMatch(CharSpan(header1.begin + 1, header1.size - 1),
+                    CharSpan(header2.begin + 1, header2.size - 1));
+}
+
+}  // namespace
+
+CharSpan MateName(const CharSpan &name) {
+  size_t size = 0;
+
+  while (size < name.size && name.data[size] != ' ' &&
+         name.data[size] != '\t') {
+    ++size;
+  }
+
+  if (size >= 2 && name.data[size - 2] == '/' &&
+      (name.data[size - 1] == '1' || name.data[size - 1] == '2')) {
+    size -= 2;
+  }
+
+  return CharSpan(name.data, size);
+}
+
+bool MatesMatch(const CharSpan &name1, const CharSpan &name2) {
+  CharSpan mate1 = MateName(name1);
+  CharSpan mate2 = MateName(name2);
+
+  return mate1.size == mate2.size &&
+         std::memcmp(mate1.data, mate2.data, mate1.size) == 0;
+}
+
+size_t FindFastqCut(const char *data, const size_t size) {
+  // The last complete record starts within the last seven complete lines.
+  static const size_t kLines = 8;
+
+  Line   lines[kLines];
+  size_t n = LastLines(data, size, lines, kLines);
+
+  // Try the record starts with three complete lines after them, last first.
+  for (size_t i = (n < 4) ? 0 : n - 3; i-- > 0; ) {
+    if (lines[i].begin != data && IsFastqRecord(lines + i)) {
+      return lines[i].begin - data;
+    }
+  }
+
+  return 0;
+}
+
+size_t FindInterleavedFastqCut(const char *data, const size_t size) {
+  // The last complete pair starts within the last fifteen complete lines.
+  static const size_t kLines = 16;
+
+  Line   lines[kLines];
+  size_t n = LastLines(data, size, lines, kLines);
+
+  // Try the pair starts with seven complete lines after them, last first.
+  for (size_t i = (n < 8) ? 0 : n - 7; i-- > 0; ) {
+    const Line *pair = lines + i;
+
+    if (pair[0].begin != data && IsFastqRecord(pair) &&
+        IsFastqRecord(pair + 4) && IsMate(pair[0], pair[4])) {
+      return pair[0].begin - data;
+    }
+  }
+
+  return 0;
+}
+
+size_t FindFastaCut(const char *data, const size_t size) {
+  for (size_t i = size; i-- > 1; ) {
+    if (data[i] == '>' && data[i - 1] == '\n') {
+      return i;
+    }
+  }
+
+  return 0;
+}
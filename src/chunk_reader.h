@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_CHUNK_READER_H_
+#define BIOIO_CHUNK_READER_H_
+
+#include <string>
+#include <cstddef>
+
+#include <BioIO/seq_view.h>
+#include <BioIO/read_buffer.h>
+
+/*
+ * Reads a file in large chunks that each hold whole records, so the chunks
+ * can be parsed independently and in parallel. The chunks are cut by a
+ * format specific function that returns the offset of a verified record
+ * start in data, or 0 if it finds none, in which case the chunk is grown
+ * until one is found or end-of-file is reached.
+ */
+class ChunkReader
+{
+ public:
+  typedef size_t (*CutFunc)(const char *data, const size_t size);
+
+  /*
+   * Read file in chunks of about chunk_size chars cut by cut. Parallel
+   * decompression of the input uses the given number of threads.
+   */
+  ChunkReader(const std::string &file, const size_t chunk_size,
+              const CutFunc cut, const size_t threads);
+
+  /*
+   * Point data at the next chunk of whole records and store its size in
+   * size. Memory mapped files are chunked in place, while other input is
+   * copied into storage, which must be kept along with the chunk. The chunk
+   * stays valid for the lifetime of the ChunkReader. Returns false at
+   * end-of-file.
+   */
+  bool NextChunk(std::string &storage, const char *&data, size_t &size);
+
+  /*
+   * Return the number of threads decompressing the input in parallel, see
+   * ReadBuffer::decompress_threads.
+   */
+  size_t decompress_threads() const;
+
+ private:
+  /*
+   * Size of read buffer.
+   */
+  static const auto kBufferSize = 1024 * 1024;
+
+  /*
+   * Input being chunked.
+   */
+  ReadBuffer read_buffer_;
+
+  /*
+   * Target size of chunks.
+   */
+  const size_t chunk_size_;
+
+  /*
+   * Function locating the last record start in a chunk.
+   */
+  const CutFunc cut_;
+
+  /*
+   * Records read past the last cut, which start the next chunk.
+   */
+  std::string carry_;
+
+  /*
+   * Cut the next chunk out of the memory mapped file.
+   */
+  bool NextMappedChunk(const char *&data, size_t &size);
+
+  /*
+   * Copy the next chunk into chunk.
+   */
+  bool NextCopiedChunk(std::string &chunk);
+};
+
+/*
+ * Return the offset of the last line in data starting a FASTQ record that is
+ * followed by its three complete lines, or 0 if there is none after the
+ * start of data. A line starting with '@' may also be a quality line, so a
+ * record start is only accepted if its third line starts with '+' and its
+ * sequence and quality lines have the same length.
+ */
+size_t FindFastqCut(const char *data, const size_t size);
+
+/*
+ * Return the part of a read name identifying its pair: the name up to the
+ * first whitespace without a trailing /1 or /2.
+ */
+CharSpan MateName(const CharSpan &name);
+
+/*
+ * Tell if the read names name1 and name2 belong to mates of the same pair.
+ */
+bool MatesMatch(const CharSpan &name1, const CharSpan &name2);
+
+/*
+ * Return the offset of the last FASTQ record start in data, as found by
+ * FindFastqCut, that is followed by a complete record for its mate, or 0 if
+ * there is none after the start of data. Cutting interleaved paired input
+ * there keeps the mates of each pair in the same chunk.
+ */
+size_t FindInterleavedFastqCut(const char *data, const size_t size);
+
+/*
+ * Return the offset of the last '>' in data that starts a line, or 0 if
+ * there is none after the start of data.
+ */
+size_t FindFastaCut(const char *data, const size_t size);
+
+#endif  // BIOIO_CHUNK_READER_H_
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/fasta_index.h>
+#include <BioIO/read_buffer.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/*
+ * Size of read buffer used when building an index.
+ */
+const size_t kBufferSize = 640 * 1024;
+
+}  // namespace
+
+FastaIndex::FastaIndex() :
+  entries_(),
+  names_()
+{}
+
+FastaIndex FastaIndex::Build(const std::string &file) {
+  ReadBuffer      read_buffer(kBufferSize, file);
+  FastaIndex      index;
+  FastaIndexEntry entry = FastaIndexEntry();
+  bool            in_seq     = false;
+  bool            short_line = false;
+  std::string     header;
+
+  while (true) {
+    uint64_t    line_offset = read_buffer.Offset();
+    size_t      len;
+    bool        eol  = false;
+    const char *span = read_buffer.LineSpan(len, eol);
+
+    if (!span) {
+      break;
+    }
+
+    if (len > 0 && *span == '>') {
+      if (in_seq) {
+        index.Add(entry);
+      }
+
+      header.clear();
+
+      while (span) {
+        header.append(span, len);
+        read_buffer.Skip(len);
+
+        if (eol) {
+          read_buffer.SkipEol();
+          break;
+        }
+
+        span = read_buffer.LineSpan(len, eol);
+      }
+
+      entry            = FastaIndexEntry();
+      entry.name       = header.substr(1, header.find_first_of(" \t") - 1);
+      entry.offset     = read_buffer.Offset();
+      in_seq           = true;
+      short_line       = false;
+
+      if (entry.name.empty()) {
+        std::string msg = "Error: missing sequence name";
+        throw FastaIndexException(msg);
+      }
+
+      continue;
+    }
+
+    uint64_t bases = 0;
+
+    while (span) {
+      bases += len;
+      read_buffer.Skip(len);
+
+      if (eol) {
+        read_buffer.SkipEol();
+        break;
+      }
+
+      span = read_buffer.LineSpan(len, eol);
+    }
+
+    uint64_t width = read_buffer.Offset() - line_offset;
+
+    if (!in_seq) {
+      if (bases > 0) {
+        std::string msg = "Error: File not in FASTA format";
+        throw FastaIndexException(msg);
+      }
+
+      continue;
+    }
+
+    if (bases == 0) {
+      short_line = true;
+      continue;
+    }
+
+    if (entry.length == 0) {
+      entry.line_bases = bases;
+      entry.line_width = width;
+    } else if (short_line || bases > entry.line_bases ||
+               (bases == entry.line_bases && eol && width != entry.line_width)) {
+      std::string msg = "Error: different line length in sequence: " +
+                        entry.name;
+      throw FastaIndexException(msg);
+    }
+
+    // Only the last line of a sequence may be shorter.
+    if (bases < entry.line_bases) {
+      short_line = true;
+    }
+
+    entry.length += bases;
+  }
+
+  if (in_seq) {
+    index.Add(entry);
+  }
+
+  return index;
+}
+
+FastaIndex FastaIndex::Load(const std::string &file) {
+  std::ifstream input(file);
+
+  if (!input) {
+    std::string msg = "Error: File not found or not readable: " + file;
+    throw FastaIndexException(msg);
+  }
+
+  FastaIndex  index;
+  std::string line;
+  size_t      line_number = 0;
+
+  while (std::getline(input, line)) {
+    ++line_number;
+
+    if (line.empty() || line == "\r") {
+      continue;
+    }
+
+    std::istringstream fields(line);
+    FastaIndexEntry    entry = FastaIndexEntry();
+
+    if (!std::getline(fields, entry.name, '\t') ||
+        !(fields >> entry.length >> entry.offset >> entry.line_bases >>
+          entry.line_width) || entry.name.empty() ||
+        (entry.length > 0 && entry.line_bases == 0) ||
+        entry.line_width < entry.line_bases) {
+      std::string msg = "Error: malformed FASTA index line " +
+                        std::to_string(line_number) + " in file: " + file;
+      throw FastaIndexException(msg);
+    }
+
+    index.Add(entry);
+  }
+
+  return index;
+}
+
+void FastaIndex::Save(const std::string &file) const {
+  std::ofstream output(file);
+
+  for (const auto &entry : entries_) {
+    output << entry.name << '\t' << entry.length << '\t' << entry.offset
+           << '\t' << entry.line_bases << '\t' << entry.line_width << '\n';
+  }
+
+  output.close();
+
+  if (!output) {
+    std::string msg = "Error: could not write FASTA index: " + file;
+    throw FastaIndexException(msg);
+  }
+}
+
+size_t FastaIndex::size() const {
+  return entries_.size();
+}
+
+const std::vector<FastaIndexEntry> &FastaIndex::entries() const {
+  return entries_;
+}
+
+const FastaIndexEntry *FastaIndex::Find(const std::string &name) const {
+  auto it = names_.find(name);
+
+  return (it == names_.end()) ? nullptr : &entries_[it->second];
+}
+
+uint64_t FastaIndex::BaseOffset(const FastaIndexEntry &entry,
+                                const uint64_t pos) {
+  if (entry.line_bases == 0) {
+    return entry.offset;
+  }
+
+  return entry.offset + pos / entry.line_bases * entry.line_width +
+         pos % entry.line_bases;
+}
+
+void FastaIndex::Add(const FastaIndexEntry &entry) {
+  names_.emplace(entry.name, entries_.size());
+  entries_.push_back(entry);
+}
@@ -20,37 +20,178 @@
 
 #include <BioIO/fasta_reader.h>
 #include <BioIO/read_buffer.h>
+#include <BioIO/simd.h>
 
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <algorithm>
 
 FastaReader::FastaReader(const std::string &file) :
   read_buffer_(FastaReader::kBufferSize, file),
-  name_buffer_(new char[FastaReader::kMaxNameSize]),
-  seq_buffer_(new char[FastaReader::kMaxSeqSize])
+  name_buffer_(),
+  seq_buffer_(),
+  in_record_(false),
+  packed_(false),
+  type_(SeqEntry::SeqType::nucleotide)
+{}
+
+FastaReader::FastaReader(const char *data, const size_t size) :
+  read_buffer_(data, size),
+  name_buffer_(),
+  seq_buffer_(),
+  in_record_(false),
+  packed_(false),
+  type_(SeqEntry::SeqType::nucleotide)
 {}
 
 FastaReader::~FastaReader() {
-  delete[] name_buffer_;
-  delete[] seq_buffer_;
 }
 
 std::unique_ptr<SeqEntry> FastaReader::NextEntry() {
-  std::unique_ptr<SeqEntry> seq_entry(new SeqEntry());
+  std::unique_ptr<SeqEntry> seq_entry(new SeqEntry(type_));
+
+  // Pack from the record view, so single line sequences are not copied out
+  // of the read buffer first.
+  if (packed_) {
+    SeqView view = NextView();
+
+    seq_entry->name().assign(view.name.data, view.name.size);
+    seq_entry->set_packed_seq(view.seq.data, view.seq.size);
+
+    return seq_entry;
+  }
 
-  GetName(seq_entry);
-  GetSeq(seq_entry);
+  GetName();
+  GetSeq();
+
+  seq_entry->set_name(name_buffer_);
+  seq_entry->set_seq(seq_buffer_);
 
   return seq_entry;
 }
 
+SeqView FastaReader::NextView() {
+  SeqView view;
+
+  if (!ViewRecord(view)) {
+    GetName();
+    GetSeq();
+
+    view.name = CharSpan(name_buffer_.data(), name_buffer_.size());
+    view.seq  = CharSpan(seq_buffer_.data(), seq_buffer_.size());
+  }
+
+  return view;
+}
+
+size_t FastaReader::NextBatch(std::vector<SeqEntry> &batch, const size_t n) {
+  size_t count = 0;
+
+  while (count < n && HasNextEntry()) {
+    SeqView view = NextView();
+
+    if (count == batch.size())
+      batch.emplace_back();
+
+    SeqEntry &entry = batch[count++];
+
+    entry.name().assign(view.name.data, view.name.size);
+    entry.set_type(type_);
+
+    if (packed_) {
+      entry.set_packed_seq(view.seq.data, view.seq.size);
+    } else {
+      entry.seq().assign(view.seq.data, view.seq.size);
+      entry.packed_seq().clear();
+    }
+
+    entry.scores().clear();
+  }
+
+  batch.resize(count);
+
+  return count;
+}
+
+size_t FastaReader::NextBatch(SeqBatch &batch, const size_t n) {
+  size_t count = 0;
+
+  batch.clear();
+  batch.set_type(type_);
+
+  while (count < n && HasNextEntry()) {
+    SeqView view = NextView();
+
+    batch.Append(view.name, view.seq);
+    ++count;
+  }
+
+  return count;
+}
+
+bool FastaReader::NextChunk(SeqChunk &chunk, const size_t size,
+                            const size_t overlap) {
+  if (overlap >= size) {
+    std::string msg = "Error: Chunk overlap must be less than chunk size: " +
+                      std::to_string(overlap) + " >= " + std::to_string(size);
+    throw FastaReaderException(msg);
+  }
+
+  if (in_record_) {
+    // Keep the overlap from the end of the last chunk. The chunk stopped
+    // at a sequence char, so the next one does not start a record.
+    size_t keep = std::min(overlap, chunk.seq.size());
+
+    chunk.offset += chunk.seq.size() - keep;
+    chunk.seq.erase(0, chunk.seq.size() - keep);
+    chunk.last = FillSeq(chunk.seq, size, false);
+  } else {
+    if (!HasNextEntry())
+      return false;
+
+    GetName();
+
+    chunk.name   = name_buffer_;
+    chunk.offset = 0;
+    chunk.seq.clear();
+    chunk.last   = FillSeq(chunk.seq, size, true);
+
+    if (chunk.seq.empty()) {
+      std::string msg = "Error: missing sequence";
+      throw FastaReaderException(msg);
+    }
+  }
+
+  in_record_ = !chunk.last;
+
+  return true;
+}
+
+void FastaReader::set_packed(const bool packed) {
+  if (packed && type_ != SeqEntry::SeqType::nucleotide) {
+    std::string msg = "Error: Only nucleotide sequences can be packed";
+    throw FastaReaderException(msg);
+  }
+
+  packed_ = packed;
+}
+
+void FastaReader::set_type(const SeqEntry::SeqType type) {
+  if (packed_ && type != SeqEntry::SeqType::nucleotide) {
+    std::string msg = "Error: Only nucleotide sequences can be packed";
+    throw FastaReaderException(msg);
+  }
+
+  type_ = type;
+}
+
 bool FastaReader::HasNextEntry() {
   return !read_buffer_.Eof();
 }
 
-void FastaReader::GetName(std::unique_ptr<SeqEntry> &seq_entry) {
-  int  name_index = 0;
+void FastaReader::GetName() {
   char c;
 
   while ((c = read_buffer_.NextChar()) && (c != '>')) {
@@ -61,37 +202,141 @@ void FastaReader::GetName(std::unique_ptr<SeqEntry> &seq_entry) {
     }
   }
 
-  while ((c = read_buffer_.NextChar()) && !isendl(c)) {
-    name_buffer_[name_index++] = c;
+  size_t      len;
+  bool        eol;
+  const char *span;
+
+  name_buffer_.clear();
+
+  while ((span = read_buffer_.LineSpan(len, eol))) {
+    name_buffer_.append(span, len);
+    read_buffer_.Skip(len);
+
+    if (eol) {
+      read_buffer_.SkipEol();
+      break;
+    }
   }
 
-  if (!name_index) {
+  if (name_buffer_.empty()) {
     std::string msg = "Error: missing sequence name";
     throw FastaReaderException(msg);
   }
+}
+
+void FastaReader::GetSeq() {
+  seq_buffer_.clear();
 
-  seq_entry->set_name(std::string(name_buffer_, name_index));
+  FillSeq(seq_buffer_, SIZE_MAX, true);
+
+  if (seq_buffer_.empty()) {
+    std::string msg = "Error: missing sequence";
+    throw FastaReaderException(msg);
+  }
 }
 
-void FastaReader::GetSeq(std::unique_ptr<SeqEntry> &seq_entry) {
-  int  seq_index = 0;
-  char c;
+bool FastaReader::FillSeq(std::string &seq, const size_t size,
+                          bool line_start) {
+  size_t      len;
+  const char *span;
 
-  while ((c = read_buffer_.NextChar())) {
-    if (c == '>' && isendl(read_buffer_.PrevChar())) {
-      read_buffer_.Rewind(1);
-      break;
-    }
+  // Copy runs of sequence chars found by vectorised scanning and step over
+  // the whitespace between them until a '>' starts a line. A full seq stops
+  // at the next sequence char, so the whitespace before a '>' is consumed
+  // and the record end is seen with the last chunk.
+  while ((span = read_buffer_.Peek(len))) {
+    const char *pos = span;
+    const char *end = span + len;
+
+    while (pos < end) {
+      if (line_start && *pos == '>') {
+        read_buffer_.Skip(pos - span);
+        return true;
+      }
+
+      const char *run_end = Simd::FindNonSeq(pos, end);
 
-    if (isseq(c)) {
-      seq_buffer_[seq_index++] = c;
+      if (run_end != pos) {
+        if (seq.size() == size) {
+          read_buffer_.Skip(pos - span);
+          return false;
+        }
+
+        size_t n = std::min(static_cast<size_t>(run_end - pos),
+                            size - seq.size());
+
+        seq.append(pos, n);
+
+        line_start = false;
+        pos       += n;
+      } else {
+        line_start = isendl(*pos++);
+      }
     }
+
+    read_buffer_.Skip(pos - span);
   }
 
-  if (!seq_index) {
-    std::string msg = "Error: missing sequence";
-    throw FastaReaderException(msg);
+  return true;
+}
+
+bool FastaReader::ViewRecord(SeqView &view) {
+  size_t      len;
+  const char *span = read_buffer_.Peek(len);
+
+  if (!span || *span != '>')
+    return false;
+
+  const char *end = span + len;
+  const char *eol = Simd::FindEol(span + 1, end);
+
+  // The line end must be complete, so a \r needs the char after it.
+  if (eol == span + 1 || eol + 1 >= end)
+    return false;
+
+  view.name = CharSpan(span + 1, eol - span - 1);
+
+  const char *pos        = eol + 1;
+  bool        line_start = true;
+  bool        copied     = false;
+
+  view.seq = CharSpan();
+
+  // Scan like GetSeq, but leave a single line sequence in place and only
+  // collect multi-line sequences in seq_buffer_.
+  while (pos < end) {
+    if (line_start && *pos == '>')
+      break;
+
+    const char *run_end = Simd::FindNonSeq(pos, end);
+
+    if (run_end != pos) {
+      if (view.seq.empty()) {
+        view.seq = CharSpan(pos, run_end - pos);
+      } else {
+        if (!copied) {
+          seq_buffer_.assign(view.seq.data, view.seq.size);
+          copied = true;
+        }
+
+        seq_buffer_.append(pos, run_end - pos);
+      }
+
+      line_start = false;
+      pos        = run_end;
+    } else {
+      line_start = isendl(*pos++);
+    }
   }
 
-  seq_entry->set_seq(std::string(seq_buffer_, seq_index));
+  // Without the next header the record may continue in the next buffer.
+  if (pos == end || view.seq.empty())
+    return false;
+
+  if (copied)
+    view.seq = CharSpan(seq_buffer_.data(), seq_buffer_.size());
+
+  read_buffer_.Skip(pos - span);
+
+  return true;
 }
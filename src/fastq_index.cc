@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/fastq_index.h>
+#include <BioIO/fastq_reader.h>
+
+#include <fstream>
+#include <algorithm>
+
+#include "byte_order.h"
+
+namespace {
+
+const char kMagic[4] = {'B', 'F', 'Q', 'I'};
+
+}  // namespace
+
+FastqIndex::FastqIndex() :
+  interval_(kDefaultInterval),
+  records_(0),
+  offsets_()
+{}
+
+FastqIndex FastqIndex::Build(const std::string &file, const uint64_t interval) {
+  if (interval == 0) {
+    std::string msg = "Error: FASTQ index interval must be positive";
+    throw FastqIndexException(msg);
+  }
+
+  FastqReader reader(file);
+  FastqIndex  index;
+
+  index.interval_ = interval;
+
+  while (reader.HasNextEntry()) {
+    if (index.records_ % interval == 0) {
+      index.offsets_.push_back(reader.Offset());
+    }
+
+    reader.NextView();
+    ++index.records_;
+  }
+
+  return index;
+}
+
+FastqIndex FastqIndex::Load(const std::string &file) {
+  std::ifstream input(file, std::ifstream::in | std::ifstream::binary);
+
+  if (!input) {
+    std::string msg = "Error: File not found or not readable: " + file;
+    throw FastqIndexException(msg);
+  }
+
+  FastqIndex index;
+  char       magic[sizeof(kMagic)];
+  uint64_t   count;
+
+  if (!input.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), kMagic) ||
+      !ReadUint64(input, index.interval_) ||
+      !ReadUint64(input, index.records_) ||
+      !ReadUint64(input, count) ||
+      index.interval_ == 0 ||
+      count != (index.records_ + index.interval_ - 1) / index.interval_) {
+    std::string msg = "Error: malformed FASTQ index file: " + file;
+    throw FastqIndexException(msg);
+  }
+
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t offset;
+
+    if (!ReadUint64(input, offset) ||
+        (i > 0 && offset <= index.offsets_.back())) {
+      std::string msg = "Error: malformed FASTQ index file: " + file;
+      throw FastqIndexException(msg);
+    }
+
+    index.offsets_.push_back(offset);
+  }
+
+  return index;
+}
+
+void FastqIndex::Save(const std::string &file) const {
+  std::ofstream output(file, std::ofstream::out | std::ofstream::binary);
+
+  output.write(kMagic, sizeof(kMagic));
+  WriteUint64(output, interval_);
+  WriteUint64(output, records_);
+  WriteUint64(output, offsets_.size());
+
+  for (const auto offset : offsets_) {
+    WriteUint64(output, offset);
+  }
+
+  output.close();
+
+  if (!output) {
+    std::string msg = "Error: could not write FASTQ index: " + file;
+    throw FastqIndexException(msg);
+  }
+}
+
+uint64_t FastqIndex::interval() const {
+  return interval_;
+}
+
+uint64_t FastqIndex::records() const {
+  return records_;
+}
+
+const std::vector<uint64_t> &FastqIndex::offsets() const {
+  return offsets_;
+}
+
+uint64_t FastqIndex::Locate(uint64_t record, uint64_t &skip) const {
+  if (record >= records_) {
+    std::string msg = "Error: Record out of range: " + std::to_string(record) +
+                      " >= " + std::to_string(records_);
+    throw FastqIndexException(msg);
+  }
+
+  skip = record % interval_;
+
+  return offsets_[record / interval_];
+}
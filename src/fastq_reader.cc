@@ -19,51 +19,308 @@
  */
 
 #include <BioIO/fastq_reader.h>
+#include <BioIO/fastq_index.h>
 #include <BioIO/read_buffer.h>
+#include <BioIO/simd.h>
 
+#include <cmath>
 #include <sstream>
 #include <iostream>
 #include <string>
 
+namespace {
+
+/*
+ * Lowest Solexa score char, for score -5.
+ */
+const uint8_t kSolexaMinChar = ';';
+
+/*
+ * Phred score of each Solexa score char from kSolexaMinChar to '~'.
+ */
+struct SolexaTable {
+  uint8_t phred[127 - kSolexaMinChar];
+
+  SolexaTable() {
+    for (int i = 0; i < 127 - kSolexaMinChar; ++i) {
+      double solexa = i + kSolexaMinChar - 64;
+
+      phred[i] = static_cast<uint8_t>(
+        std::lround(10 * std::log10(std::pow(10, solexa / 10) + 1)));
+    }
+  }
+};
+
+const SolexaTable kSolexaTable;
+
+}  // namespace
+
 FastqReader::FastqReader(const std::string &file) :
   read_buffer_(FastqReader::kBufferSize, file),
   encoding_(kDefaultEncoding),
-  name_buffer_(new char[FastqReader::kMaxNameSize]),
-  seq_buffer_(new char[FastqReader::kMaxSeqSize]),
-  scores_buffer_(new char[FastqReader::kMaxScoresSize])
+  solexa_(false),
+  detect_(false),
+  name_buffer_(),
+  seq_buffer_(),
+  scores_buffer_(),
+  end_offset_(UINT64_MAX),
+  packed_(false),
+  score_mode_(ScoreMode::decode)
 {}
 
 FastqReader::FastqReader(const std::string &file, const int encoding) :
   read_buffer_(FastqReader::kBufferSize, file),
   encoding_(encoding),
-  name_buffer_(new char[FastqReader::kMaxNameSize]),
-  seq_buffer_(new char[FastqReader::kMaxSeqSize]),
-  scores_buffer_(new char[FastqReader::kMaxScoresSize])
+  solexa_(false),
+  detect_(false),
+  name_buffer_(),
+  seq_buffer_(),
+  scores_buffer_(),
+  end_offset_(UINT64_MAX),
+  packed_(false),
+  score_mode_(ScoreMode::decode)
 {}
 
-FastqReader::~FastqReader()
+FastqReader::FastqReader(const std::string &file, const Encoding encoding) :
+  read_buffer_(FastqReader::kBufferSize, file),
+  encoding_(kDefaultEncoding),
+  solexa_(false),
+  detect_(false),
+  name_buffer_(),
+  seq_buffer_(),
+  scores_buffer_(),
+  end_offset_(UINT64_MAX),
+  packed_(false),
+  score_mode_(ScoreMode::decode)
 {
-  delete[] name_buffer_;
-  delete[] seq_buffer_;
-  delete[] scores_buffer_;
+  SetEncoding(encoding);
 }
 
+FastqReader::FastqReader(const char *data, const size_t size,
+                         const int encoding) :
+  read_buffer_(data, size),
+  encoding_(encoding),
+  solexa_(false),
+  detect_(false),
+  name_buffer_(),
+  seq_buffer_(),
+  scores_buffer_(),
+  end_offset_(UINT64_MAX),
+  packed_(false),
+  score_mode_(ScoreMode::decode)
+{}
+
+FastqReader::~FastqReader()
+{}
+
 std::unique_ptr<SeqEntry> FastqReader::NextEntry() {
   std::unique_ptr<SeqEntry> seq_entry(new SeqEntry());
 
-  GetName(seq_entry);
-  GetSeq(seq_entry);
-  GetScores(seq_entry);
+  if (detect_)
+    DetectEncoding();
+
+  // Pack from the record view, so the sequence is not copied out of the
+  // read buffer first.
+  if (packed_) {
+    SeqView view = NextView();
+
+    seq_entry->name().assign(view.name.data, view.name.size);
+    seq_entry->set_packed_seq(view.seq.data, view.seq.size);
+
+    SetScores(*seq_entry, view.scores);
+
+    return seq_entry;
+  }
+
+  GetName();
+  GetSeq();
+  GetScores();
+
+  seq_entry->set_name(name_buffer_);
+  seq_entry->set_seq(seq_buffer_);
+
+  SetScores(*seq_entry, CharSpan(scores_buffer_.data(), scores_buffer_.size()));
 
   return seq_entry;
 }
 
+SeqView FastqReader::NextView() {
+  SeqView view;
+
+  if (!ViewRecord(view)) {
+    GetName();
+    GetSeq();
+    GetScores();
+
+    view.name   = CharSpan(name_buffer_.data(), name_buffer_.size());
+    view.seq    = CharSpan(seq_buffer_.data(), seq_buffer_.size());
+    view.scores = CharSpan(scores_buffer_.data(), scores_buffer_.size());
+  }
+
+  return view;
+}
+
+size_t FastqReader::NextBatch(std::vector<SeqEntry> &batch, const size_t n) {
+  size_t count = 0;
+
+  if (detect_)
+    DetectEncoding();
+
+  while (count < n && HasNextEntry()) {
+    SeqView view = NextView();
+
+    if (count == batch.size())
+      batch.emplace_back();
+
+    SeqEntry &entry = batch[count++];
+
+    entry.name().assign(view.name.data, view.name.size);
+    entry.set_type(SeqEntry::SeqType::nucleotide);
+
+    if (packed_) {
+      entry.set_packed_seq(view.seq.data, view.seq.size);
+    } else {
+      entry.seq().assign(view.seq.data, view.seq.size);
+      entry.packed_seq().clear();
+    }
+
+    SetScores(entry, view.scores);
+  }
+
+  batch.resize(count);
+
+  return count;
+}
+
+size_t FastqReader::NextBatch(SeqBatch &batch, const size_t n) {
+  size_t count = 0;
+
+  batch.clear();
+  batch.set_type(SeqEntry::SeqType::nucleotide);
+
+  while (count < n && AppendEntry(batch)) {
+    ++count;
+  }
+
+  return count;
+}
+
+bool FastqReader::AppendEntry(SeqBatch &batch) {
+  if (detect_)
+    DetectEncoding();
+
+  if (!HasNextEntry()) {
+    return false;
+  }
+
+  SeqView view = NextView();
+
+  if (score_mode_ == ScoreMode::skip) {
+    batch.Append(view.name, view.seq);
+  } else {
+    DecodeScores(view.scores,
+                 batch.Append(view.name, view.seq, view.scores.size));
+  }
+
+  return true;
+}
+
+void FastqReader::set_packed(const bool packed) {
+  packed_ = packed;
+}
+
+FastqReader::Encoding FastqReader::encoding() {
+  if (detect_)
+    DetectEncoding();
+
+  if (solexa_)
+    return Encoding::solexa;
+
+  return (encoding_ == 64) ? Encoding::phred64 : Encoding::phred33;
+}
+
+void FastqReader::set_score_mode(const ScoreMode mode) {
+  score_mode_ = mode;
+}
+
 bool FastqReader::HasNextEntry() {
-  return !read_buffer_.Eof();
+  return read_buffer_.Offset() < end_offset_ && !read_buffer_.Eof();
+}
+
+uint64_t FastqReader::Offset() const {
+  return read_buffer_.Offset();
+}
+
+void FastqReader::SeekRecord(const FastqIndex &index, const uint64_t record) {
+  uint64_t skip;
+  uint64_t offset = index.Locate(record, skip);
+
+  read_buffer_.Seek(offset);
+  end_offset_ = UINT64_MAX;
+
+  for (; skip > 0; --skip) {
+    NextView();
+  }
 }
 
-void FastqReader::GetName(std::unique_ptr<SeqEntry> &seq_entry) {
-  int  name_index = 0;
+void FastqReader::SeekShard(const size_t shard, const size_t shards) {
+  if (shard >= shards) {
+    std::string msg = "Error: Shard out of range: " + std::to_string(shard) +
+                      " >= " + std::to_string(shards);
+    throw FastqReaderException(msg);
+  }
+
+  // Split the remainder over the shards without overflowing for large files.
+  const uint64_t size  = read_buffer_.Size();
+  const uint64_t quot  = size / shards;
+  const uint64_t rem   = size % shards;
+  const uint64_t begin = quot * shard + rem * shard / shards;
+  const uint64_t end   = quot * (shard + 1) + rem * (shard + 1) / shards;
+
+  Resync(begin);
+
+  end_offset_ = end;
+}
+
+void FastqReader::Resync(const uint64_t offset) {
+  if (offset == 0) {
+    read_buffer_.Seek(0);
+    return;
+  }
+
+  // Start at the first line beginning at or after offset.
+  read_buffer_.Seek(offset - 1);
+  SkipLine();
+
+  // A record starts on one of the first four lines, and telling it from a
+  // scores line starting with '@' takes the three lines after it.
+  const size_t kLines = 7;
+  uint64_t     starts[kLines];
+  std::string  lines[kLines];
+  size_t       count = 0;
+
+  while (count < kLines && !read_buffer_.Eof()) {
+    starts[count] = read_buffer_.Offset();
+    GetLine(lines[count++]);
+  }
+
+  for (size_t i = 0; i < 4 && i + 3 < count; ++i) {
+    if (lines[i].size() > 1 && lines[i][0] == '@' &&
+        !lines[i + 2].empty() && lines[i + 2][0] == '+' &&
+        !lines[i + 1].empty() && lines[i + 1].size() == lines[i + 3].size()) {
+      read_buffer_.Seek(starts[i]);
+      return;
+    }
+  }
+
+  // Without a complete record left the reader stays at end-of-file.
+  if (count == kLines) {
+    std::string msg = "Error: File not in FASTQ format";
+    throw FastqReaderException(msg);
+  }
+}
+
+void FastqReader::GetName() {
   char c;
 
   while ((c = read_buffer_.NextChar()) && (c != '@')) {
@@ -74,62 +331,207 @@ void FastqReader::GetName(std::unique_ptr<SeqEntry> &seq_entry) {
     }
   }
 
-  while ((c = read_buffer_.NextChar()) && !isendl(c)) {
-    name_buffer_[name_index++] = c;
-  }
+  GetLine(name_buffer_);
 
-  if (!name_index) {
+  if (name_buffer_.empty()) {
     std::string msg = "Error: missing sequence name";
     throw FastqReaderException(msg);
   }
-
-  seq_entry->set_name(std::string(name_buffer_, name_index));
 }
 
-void FastqReader::GetSeq(std::unique_ptr<SeqEntry> &seq_entry) {
-  int  seq_index = 0;
-  char c;
-
-  while ((c = read_buffer_.NextChar()) && !isendl(c)) {
-    seq_buffer_[seq_index++] = c;
-  }
+void FastqReader::GetSeq() {
+  GetLine(seq_buffer_);
 
-  if (!seq_index) {
+  if (seq_buffer_.empty()) {
     std::string msg = "Error: missing sequence";
     throw FastqReaderException(msg);
   }
-
-  seq_entry->set_seq(std::string(seq_buffer_, seq_index));
 }
 
-void FastqReader::GetScores(std::unique_ptr<SeqEntry> &seq_entry) {
-  size_t scores_index = 0;
-  char c;
-
+void FastqReader::GetScores() {
   // Skip comment line.
-  while ((c = read_buffer_.NextChar()) && !isendl(c)) {}
+  SkipLine();
 
-  while ((c = read_buffer_.NextChar()) && !isendl(c)) {
-    scores_buffer_[scores_index++] = c;
-  }
+  GetLine(scores_buffer_);
+
+  size_t scores_index = scores_buffer_.size();
 
   if (!scores_index) {
     std::string msg = "Error: missing scores";
     throw FastqReaderException(msg);
   }
 
-  if (seq_entry->Size() != scores_index) {
+  if (seq_buffer_.size() != scores_index) {
     std::string msg = "Error: Sequence length != scores length: " +
-                      std::to_string(seq_entry->Size()) + " != " +
+                      std::to_string(seq_buffer_.size()) + " != " +
                       std::to_string(scores_index);
     throw FastqReaderException(msg);
   }
+}
+
+bool FastqReader::ViewRecord(SeqView &view) {
+  size_t      len;
+  const char *span = read_buffer_.Peek(len);
+
+  if (!span || *span != '@')
+    return false;
+
+  const char *end = span + len;
+  const char *pos = span + 1;
+  CharSpan    lines[4];
+
+  // Locate the four lines; each line end must be complete, so a \r needs
+  // the char after it.
+  for (auto &line : lines) {
+    const char *eol = Simd::FindEol(pos, end);
 
-  std::vector<uint8_t> scores(scores_index, 0);
+    if (eol + 1 >= end)
+      return false;
 
-  for (size_t i = 0; i < scores_index; ++i) {
-    scores[i] = scores_buffer_[i] - encoding_;
+    line = CharSpan(pos, eol - pos);
+    pos  = eol + 1;
+
+    if (*eol == '\r' && *pos == '\n')
+      ++pos;
   }
 
-  seq_entry->set_scores(scores);
+  // Leave malformed records to the copying path, which reports the error.
+  if (lines[0].empty() || lines[1].empty() || lines[3].empty() ||
+      lines[1].size != lines[3].size)
+    return false;
+
+  view.name   = lines[0];
+  view.seq    = lines[1];
+  view.scores = lines[3];
+
+  read_buffer_.Skip(pos - span);
+
+  return true;
+}
+
+void FastqReader::SetEncoding(const Encoding encoding) {
+  encoding_ = (encoding == Encoding::phred33) ? 33 : 64;
+  solexa_   = (encoding == Encoding::solexa);
+  detect_   = (encoding == Encoding::automatic);
+}
+
+void FastqReader::DetectEncoding() {
+  uint8_t     min = 255;
+  uint8_t     max = 0;
+  size_t      len;
+  const char *span = read_buffer_.Peek(len);
+  const char *pos  = span;
+  const char *end  = span + len;
+
+  // Sample the fourth line of each complete record in the buffer.
+  for (size_t n = 0; span && n < kDetectRecords; ++n) {
+    CharSpan scores;
+    size_t   line = 0;
+
+    for (; line < 4; ++line) {
+      const char *eol = Simd::FindEol(pos, end);
+
+      if (eol == end)
+        break;
+
+      scores = CharSpan(pos, eol - pos);
+      pos    = eol + 1;
+
+      if (*eol == '\r' && pos < end && *pos == '\n')
+        ++pos;
+    }
+
+    if (line < 4)
+      break;
+
+    Simd::MinMax(scores.begin(), scores.end(), min, max);
+  }
+
+  if (min > max || min < kSolexaMinChar || max <= 'K')
+    SetEncoding(Encoding::phred33);
+  else if (min < '@')
+    SetEncoding(Encoding::solexa);
+  else
+    SetEncoding(Encoding::phred64);
+}
+
+void FastqReader::SetScores(SeqEntry &entry, const CharSpan &encoded) {
+  // Drop raw scores left in a reused entry rather than decode them.
+  if (score_mode_ != ScoreMode::lazy && !entry.raw_scores().empty())
+    entry.set_scores(std::vector<uint8_t>());
+
+  if (score_mode_ == ScoreMode::skip) {
+    entry.scores().clear();
+    return;
+  }
+
+  // SeqEntry only decodes offset scores, so Solexa scores are converted
+  // right away.
+  if (score_mode_ == ScoreMode::lazy && !solexa_) {
+    entry.set_raw_scores(encoded.data, encoded.size, encoding_);
+    return;
+  }
+
+  std::vector<uint8_t> &scores = entry.scores();
+
+  scores.resize(encoded.size);
+  DecodeScores(encoded, scores.data());
+}
+
+void FastqReader::DecodeScores(const CharSpan &encoded, uint8_t *scores) {
+  const uint8_t offset = solexa_ ? kSolexaMinChar : encoding_;
+
+  if (Simd::DecodeScores(encoded.data, encoded.size, offset, scores)) {
+    if (solexa_) {
+      for (size_t i = 0; i < encoded.size; ++i) {
+        scores[i] = kSolexaTable.phred[scores[i]];
+      }
+    }
+
+    return;
+  }
+
+  // Find the offending score for the message.
+  for (const char c : encoded) {
+    unsigned char score = c;
+
+    if (score < offset || score > 126) {
+      std::string msg = "Error: Score char " + std::to_string(score) +
+                        " out of range for encoding " +
+                        (solexa_ ? "Solexa" : std::to_string(encoding_));
+      throw FastqReaderException(msg);
+    }
+  }
+}
+
+void FastqReader::GetLine(std::string &line) {
+  size_t      len;
+  bool        eol;
+  const char *span;
+
+  line.clear();
+
+  while ((span = read_buffer_.LineSpan(len, eol))) {
+    line.append(span, len);
+    read_buffer_.Skip(len);
+
+    if (eol) {
+      read_buffer_.SkipEol();
+      break;
+    }
+  }
+}
+
+void FastqReader::SkipLine() {
+  size_t len;
+  bool   eol;
+
+  while (read_buffer_.LineSpan(len, eol)) {
+    read_buffer_.Skip(len);
+
+    if (eol) {
+      read_buffer_.SkipEol();
+      break;
+    }
+  }
 }
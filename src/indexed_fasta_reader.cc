@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/indexed_fasta_reader.h>
+#include <BioIO/simd.h>
+
+#include <fstream>
+#include <algorithm>
+
+#include "input_source.h"
+
+namespace {
+
+/*
+ * Return true if file exists and can be read.
+ */
+bool Readable(const std::string &file) {
+  std::ifstream input(file);
+
+  return input.good();
+}
+
+/*
+ * Parse a 1-based position with optional thousands separators and store it
+ * in pos. Returns false if str is not a valid position.
+ */
+bool ParsePos(const std::string &str, uint64_t &pos) {
+  pos = 0;
+
+  bool digits = false;
+
+  for (char c : str) {
+    if (c == ',') {
+      continue;
+    }
+
+    if (c < '0' || c > '9' || pos > (UINT64_MAX - 9) / 10) {
+      return false;
+    }
+
+    pos    = pos * 10 + (c - '0');
+    digits = true;
+  }
+
+  return digits && pos > 0;
+}
+
+}  // namespace
+
+IndexedFastaReader::IndexedFastaReader(const std::string &file) :
+  file_(file),
+  index_(Readable(file + ".fai") ? FastaIndex::Load(file + ".fai")
+                                 : FastaIndex::Build(file)),
+  input_(),
+  bgzf_input_(),
+  bgzf_index_(),
+  block_buffer_(),
+  raw_buffer_()
+{
+  Open();
+}
+
+IndexedFastaReader::IndexedFastaReader(const std::string &file,
+                                       const FastaIndex &index) :
+  file_(file),
+  index_(index),
+  input_(),
+  bgzf_input_(),
+  bgzf_index_(),
+  block_buffer_(),
+  raw_buffer_()
+{
+  Open();
+}
+
+IndexedFastaReader::~IndexedFastaReader()
+{}
+
+void IndexedFastaReader::Open() {
+  input_.open(file_, std::ios::binary);
+
+  if (!input_) {
+    std::string msg = "Error: File not found or not readable: " + file_;
+    throw IndexedFastaReaderException(msg);
+  }
+
+  char magic[kMagicSize];
+
+  input_.read(magic, sizeof(magic));
+
+  Compression compression = DetectCompression(magic, input_.gcount());
+
+  if (compression == Compression::bgzf) {
+    input_.close();
+
+    bgzf_index_ = Readable(file_ + ".gzi") ? BgzfIndex::Load(file_ + ".gzi")
+                                           : BgzfIndex::Build(file_);
+    bgzf_input_.reset(new StreamSource(file_));
+  } else if (compression != Compression::none) {
+    std::string msg = "Error: Compressed file cannot be read by region "
+                      "unless BGZF compressed: " + file_;
+    throw IndexedFastaReaderException(msg);
+  }
+}
+
+std::string IndexedFastaReader::Fetch(const std::string &region) {
+  if (index_.Find(region)) {
+    return Fetch(region, 0, UINT64_MAX);
+  }
+
+  size_t colon = region.rfind(':');
+
+  if (colon == std::string::npos) {
+    std::string msg = "Error: unknown sequence name: " + region;
+    throw IndexedFastaReaderException(msg);
+  }
+
+  std::string name  = region.substr(0, colon);
+  std::string range = region.substr(colon + 1);
+  size_t      dash  = range.find('-');
+  uint64_t    begin;
+  uint64_t    end   = UINT64_MAX;
+
+  if (!ParsePos(range.substr(0, dash), begin) ||
+      (dash != std::string::npos && !ParsePos(range.substr(dash + 1), end)) ||
+      end < begin) {
+    std::string msg = "Error: invalid region: " + region;
+    throw IndexedFastaReaderException(msg);
+  }
+
+  return Fetch(name, begin - 1, end);
+}
+
+std::string IndexedFastaReader::Fetch(const std::string &name, uint64_t begin,
+                                      uint64_t end) {
+  std::string seq;
+
+  Fetch(name, begin, end, seq);
+
+  return seq;
+}
+
+void IndexedFastaReader::Fetch(const std::string &name, uint64_t begin,
+                               uint64_t end, std::string &seq) {
+  const FastaIndexEntry &entry = Entry(name);
+
+  end = std::min(end, entry.length);
+
+  seq.clear();
+
+  if (begin >= end) {
+    return;
+  }
+
+  uint64_t first = FastaIndex::BaseOffset(entry, begin);
+  uint64_t last  = FastaIndex::BaseOffset(entry, end - 1) + 1;
+
+  ReadRaw(first, last - first);
+
+  // Copy the bases between the line ends.
+  const char *pos = raw_buffer_.data();
+  const char *fin = pos + raw_buffer_.size();
+
+  seq.reserve(end - begin);
+
+  while (pos < fin) {
+    const char *eol = Simd::FindEol(pos, fin);
+
+    seq.append(pos, eol - pos);
+
+    pos = eol;
+
+    while (pos < fin && (*pos == '\n' || *pos == '\r')) {
+      ++pos;
+    }
+  }
+}
+
+void IndexedFastaReader::ReadRaw(uint64_t offset, uint64_t size) {
+  if (!bgzf_input_) {
+    raw_buffer_.resize(size);
+
+    input_.clear();
+    input_.seekg(offset);
+    input_.read(&raw_buffer_[0], size);
+
+    if (static_cast<uint64_t>(input_.gcount()) != size) {
+      std::string msg = "Error: FASTA file is shorter than its index: " + file_;
+      throw IndexedFastaReaderException(msg);
+    }
+
+    return;
+  }
+
+  // Inflate the blocks from the one holding offset until size bytes are
+  // read.
+  const BgzfBlock &block = bgzf_index_.Locate(offset);
+  uint64_t         skip  = offset - block.uncompressed_offset;
+
+  bgzf_input_->Seek(block.compressed_offset);
+  raw_buffer_.clear();
+
+  while (raw_buffer_.size() < size) {
+    if (!BgzfSource::ReadBlock(*bgzf_input_, block_buffer_)) {
+      std::string msg = "Error: FASTA file is shorter than its index: " + file_;
+      throw IndexedFastaReaderException(msg);
+    }
+
+    std::string data = BgzfSource::InflateBlock(block_buffer_);
+
+    if (skip >= data.size()) {
+      skip -= data.size();
+      continue;
+    }
+
+    raw_buffer_.append(data, skip, size - raw_buffer_.size());
+    skip = 0;
+  }
+}
+
+const FastaIndex &IndexedFastaReader::index() const {
+  return index_;
+}
+
+const FastaIndexEntry &IndexedFastaReader::Entry(const std::string &name) const {
+  const FastaIndexEntry *entry = index_.Find(name);
+
+  if (!entry) {
+    std::string msg = "Error: unknown sequence name: " + name;
+    throw IndexedFastaReaderException(msg);
+  }
+
+  return *entry;
+}
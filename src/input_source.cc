@@ -0,0 +1,850 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <BioIO/read_buffer.h>
+
+#include "input_source.h"
+
+Compression DetectCompression(const char *data, size_t len) {
+  const unsigned char *magic = reinterpret_cast<const unsigned char *>(data);
+
+  if (len >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+    // BGZF has the extra field flag set and starts with a BC subfield.
+    if (len >= 14 && (magic[3] & 4) && magic[12] == 'B' && magic[13] == 'C') {
+      return Compression::bgzf;
+    }
+
+    return Compression::gzip;
+  }
+
+  if (len >= 4 && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h' &&
+      magic[3] >= '1' && magic[3] <= '9') {
+    return Compression::bzip2;
+  }
+
+  if (len >= 6 && magic[0] == 0xfd && magic[1] == '7' && magic[2] == 'z' &&
+      magic[3] == 'X' && magic[4] == 'Z' && magic[5] == 0x00) {
+    return Compression::xz;
+  }
+
+  // Zstandard frames, or skippable frames as written first by pzstd.
+  if (len >= 4 && ((magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f &&
+                    magic[3] == 0xfd) ||
+                   ((magic[0] & 0xf0) == 0x50 && magic[1] == 0x2a &&
+                    magic[2] == 0x4d && magic[3] == 0x18))) {
+    return Compression::zstd;
+  }
+
+  return Compression::none;
+}
+
+StreamSource::StreamSource(const std::string &file) :
+  input_stream_(),
+  input_(nullptr),
+  peeked_()
+{
+  if (file == ReadBuffer::kStdin) {
+    input_ = &std::cin;
+  } else {
+    input_stream_.rdbuf()->pubsetbuf(0, 0);
+    input_stream_.open(file, std::ifstream::in | std::ifstream::binary);
+
+    if (!input_stream_.good()) {
+      std::string msg("Error: File not found or not readable: " + file);
+      throw ReadBufferException(msg);
+    }
+
+    input_ = &input_stream_;
+  }
+}
+
+size_t StreamSource::Read(char *dst, size_t len) {
+  size_t size = 0;
+
+  if (!peeked_.empty()) {
+    size = std::min(len, peeked_.size());
+
+    memcpy(dst, peeked_.data(), size);
+    peeked_.erase(0, size);
+  }
+
+  if (size == len || !input_->good()) {
+    return size;
+  }
+
+  input_->read(dst + size, len - size);
+
+  if (input_->bad()) {
+    std::string msg("Error: Failed to read from input");
+    throw ReadBufferException(msg);
+  }
+
+  return size + input_->gcount();
+}
+
+size_t StreamSource::Peek(char *dst, size_t len) {
+  if (peeked_.size() < len && input_->good()) {
+    size_t size = peeked_.size();
+
+    peeked_.resize(len);
+    input_->read(&peeked_[size], len - size);
+    peeked_.resize(size + input_->gcount());
+  }
+
+  size_t size = std::min(len, peeked_.size());
+
+  memcpy(dst, peeked_.data(), size);
+
+  return size;
+}
+
+void InputSource::Seek(uint64_t offset) {
+  (void) offset;
+
+  std::string msg("Error: Input cannot seek");
+  throw ReadBufferException(msg);
+}
+
+size_t InputSource::Threads() const {
+  return 0;
+}
+
+void StreamSource::Seek(uint64_t offset) {
+  peeked_.clear();
+
+  input_->clear();
+  input_->seekg(offset);
+
+  if (!input_->good()) {
+    std::string msg("Error: Failed to seek in input");
+    throw ReadBufferException(msg);
+  }
+}
+
+GzipSource::GzipSource(std::unique_ptr<InputSource> source) :
+  source_(std::move(source)),
+  buffer_(new char[GzipSource::kBufferSize]),
+  stream_(),
+  eof_(false),
+  member_end_(false)
+{
+  stream_.zalloc   = Z_NULL;
+  stream_.zfree    = Z_NULL;
+  stream_.opaque   = Z_NULL;
+  stream_.next_in  = Z_NULL;
+  stream_.avail_in = 0;
+
+  // Window size 15 plus 32 detects both gzip and zlib headers.
+  if (inflateInit2(&stream_, 15 + 32) != Z_OK) {
+    delete[] buffer_;
+
+    std::string msg("Error: Failed to initialise gzip decompression");
+    throw ReadBufferException(msg);
+  }
+}
+
+GzipSource::~GzipSource() {
+  inflateEnd(&stream_);
+  delete[] buffer_;
+}
+
+size_t GzipSource::Read(char *dst, size_t len) {
+  stream_.next_out  = reinterpret_cast<Bytef *>(dst);
+  stream_.avail_out = len;
+
+  while (stream_.avail_out > 0) {
+    if (stream_.avail_in == 0 && !eof_) {
+      size_t size = source_->Read(buffer_, GzipSource::kBufferSize);
+
+      eof_              = (size == 0);
+      stream_.next_in   = reinterpret_cast<Bytef *>(buffer_);
+      stream_.avail_in  = size;
+    }
+
+    if (member_end_) {
+      if (stream_.avail_in == 0) {
+        break;
+      }
+
+      inflateReset(&stream_);
+      member_end_ = false;
+    }
+
+    if (stream_.avail_in == 0) {
+      std::string msg("Error: Unexpected end of gzip compressed input");
+      throw ReadBufferException(msg);
+    }
+
+    int ret = inflate(&stream_, Z_NO_FLUSH);
+
+    if (ret == Z_STREAM_END) {
+      member_end_ = true;
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      std::string msg("Error: Failed to decompress gzip input: " +
+                      std::string(stream_.msg ? stream_.msg : "unknown error"));
+      throw ReadBufferException(msg);
+    }
+  }
+
+  return len - stream_.avail_out;
+}
+
+BgzfSource::BgzfSource(std::unique_ptr<InputSource> source,
+                       const size_t threads) :
+  source_(std::move(source)),
+  pool_(threads),
+  pending_(),
+  block_(),
+  block_pos_(0),
+  eof_(false),
+  error_()
+{}
+
+size_t BgzfSource::Read(char *dst, size_t len) {
+  size_t size = 0;
+
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+
+  while (size < len) {
+    if (block_pos_ == block_.size()) {
+      FillPending();
+
+      if (pending_.empty()) {
+        break;
+      }
+
+      // Take the task off the queue first, so a failed block is not left
+      // behind for the next call.
+      std::future<std::string> next = std::move(pending_.front());
+
+      pending_.pop_front();
+
+      try {
+        block_ = next.get();
+      } catch (...) {
+        error_ = std::current_exception();
+        throw;
+      }
+
+      block_pos_ = 0;
+
+      continue;
+    }
+
+    size_t chunk = std::min(len - size, block_.size() - block_pos_);
+
+    memcpy(dst + size, block_.data() + block_pos_, chunk);
+
+    size       += chunk;
+    block_pos_ += chunk;
+  }
+
+  return size;
+}
+
+size_t BgzfSource::Threads() const {
+  return pool_.size();
+}
+
+void BgzfSource::FillPending() {
+  while (!eof_ && pending_.size() < pool_.size() * kBlocksPerThread) {
+    auto block = std::make_shared<std::string>();
+
+    if (!ReadBlock(*source_, *block)) {
+      eof_ = true;
+      break;
+    }
+
+    pending_.push_back(pool_.Submit([block] { return InflateBlock(*block); }));
+  }
+}
+
+bool BgzfSource::ReadBlock(InputSource &source, std::string &block) {
+  static const size_t kHeaderSize = 12;
+
+  block.resize(kHeaderSize);
+
+  size_t size = ReadFully(source, &block[0], kHeaderSize);
+
+  if (size == 0) {
+    return false;
+  }
+
+  const unsigned char *header =
+    reinterpret_cast<const unsigned char *>(block.data());
+
+  if (size < kHeaderSize || header[0] != 0x1f || header[1] != 0x8b ||
+      !(header[3] & 4)) {
+    std::string msg("Error: Invalid BGZF block header");
+    throw ReadBufferException(msg);
+  }
+
+  size_t extra_size = header[10] | (header[11] << 8);
+
+  block.resize(kHeaderSize + extra_size);
+
+  if (ReadFully(source, &block[kHeaderSize], extra_size) < extra_size) {
+    std::string msg("Error: Unexpected end of BGZF compressed input");
+    throw ReadBufferException(msg);
+  }
+
+  // Find the BC subfield holding the total block size minus 1.
+  const unsigned char *extra =
+    reinterpret_cast<const unsigned char *>(block.data()) + kHeaderSize;
+  size_t block_size = 0;
+
+  for (size_t i = 0; i + 4 <= extra_size; ) {
+    size_t field_size = extra[i + 2] | (extra[i + 3] << 8);
+
+    if (extra[i] == 'B' && extra[i + 1] == 'C' && field_size == 2 &&
+        i + 6 <= extra_size) {
+      block_size = (extra[i + 4] | (extra[i + 5] << 8)) + 1;
+      break;
+    }
+
+    i += 4 + field_size;
+  }
+
+  size_t header_size = kHeaderSize + extra_size;
+
+  // Trailer holds CRC32 and uncompressed size.
+  if (block_size < header_size + 8) {
+    std::string msg("Error: Invalid BGZF block header");
+    throw ReadBufferException(msg);
+  }
+
+  block.resize(block_size);
+
+  if (ReadFully(source, &block[header_size], block_size - header_size) <
+      block_size - header_size) {
+    std::string msg("Error: Unexpected end of BGZF compressed input");
+    throw ReadBufferException(msg);
+  }
+
+  return true;
+}
+
+std::string BgzfSource::InflateBlock(const std::string &block) {
+  const unsigned char *data =
+    reinterpret_cast<const unsigned char *>(block.data());
+
+  size_t header_size = 12 + (data[10] | (data[11] << 8));
+  size_t trailer     = block.size() - 8;
+  uint32_t crc       = data[trailer] | (data[trailer + 1] << 8) |
+                       (data[trailer + 2] << 16) |
+                       (static_cast<uint32_t>(data[trailer + 3]) << 24);
+  size_t size        = data[trailer + 4] | (data[trailer + 5] << 8) |
+                       (data[trailer + 6] << 16) |
+                       (static_cast<uint32_t>(data[trailer + 7]) << 24);
+
+  // Reject sizes no BGZF block can inflate to before allocating them.
+  if (size > kMaxBlockSize) {
+    std::string msg("Error: Invalid BGZF block header");
+    throw ReadBufferException(msg);
+  }
+
+  std::string result(size, '\0');
+
+  if (size == 0) {
+    return result;
+  }
+
+  z_stream stream;
+
+  stream.zalloc    = Z_NULL;
+  stream.zfree     = Z_NULL;
+  stream.opaque    = Z_NULL;
+  stream.next_in   = const_cast<Bytef *>(data + header_size);
+  stream.avail_in  = trailer - header_size;
+  stream.next_out  = reinterpret_cast<Bytef *>(&result[0]);
+  stream.avail_out = size;
+
+  // Negative window size inflates raw deflate data without gzip header.
+  if (inflateInit2(&stream, -15) != Z_OK) {
+    std::string msg("Error: Failed to initialise BGZF decompression");
+    throw ReadBufferException(msg);
+  }
+
+  int ret = inflate(&stream, Z_FINISH);
+
+  inflateEnd(&stream);
+
+  if (ret != Z_STREAM_END || stream.avail_out != 0 ||
+      crc32(0, reinterpret_cast<const Bytef *>(result.data()), size) != crc) {
+    std::string msg("Error: Failed to decompress BGZF block");
+    throw ReadBufferException(msg);
+  }
+
+  return result;
+}
+
+#ifdef BIOIO_HAVE_BZIP2
+Bzip2Source::Bzip2Source(std::unique_ptr<InputSource> source) :
+  source_(std::move(source)),
+  buffer_(new char[Bzip2Source::kBufferSize]),
+  stream_(),
+  eof_(false),
+  stream_end_(false)
+{
+  stream_.bzalloc  = nullptr;
+  stream_.bzfree   = nullptr;
+  stream_.opaque   = nullptr;
+  stream_.next_in  = nullptr;
+  stream_.avail_in = 0;
+
+  if (BZ2_bzDecompressInit(&stream_, 0, 0) != BZ_OK) {
+    delete[] buffer_;
+
+    std::string msg("Error: Failed to initialise bzip2 decompression");
+    throw ReadBufferException(msg);
+  }
+}
+
+Bzip2Source::~Bzip2Source() {
+  BZ2_bzDecompressEnd(&stream_);
+  delete[] buffer_;
+}
+
+size_t Bzip2Source::Read(char *dst, size_t len) {
+  stream_.next_out  = dst;
+  stream_.avail_out = len;
+
+  while (stream_.avail_out > 0) {
+    if (stream_.avail_in == 0 && !eof_) {
+      size_t size = source_->Read(buffer_, Bzip2Source::kBufferSize);
+
+      eof_             = (size == 0);
+      stream_.next_in  = buffer_;
+      stream_.avail_in = size;
+    }
+
+    if (stream_end_) {
+      if (stream_.avail_in == 0) {
+        break;
+      }
+
+      // Restart the decoder on the next stream keeping the pending input.
+      char    *next_in  = stream_.next_in;
+      unsigned avail_in = stream_.avail_in;
+
+      BZ2_bzDecompressEnd(&stream_);
+
+      if (BZ2_bzDecompressInit(&stream_, 0, 0) != BZ_OK) {
+        std::string msg("Error: Failed to initialise bzip2 decompression");
+        throw ReadBufferException(msg);
+      }
+
+      stream_.next_in  = next_in;
+      stream_.avail_in = avail_in;
+      stream_end_      = false;
+    }
+
+    if (stream_.avail_in == 0) {
+      std::string msg("Error: Unexpected end of bzip2 compressed input");
+      throw ReadBufferException(msg);
+    }
+
+    int ret = BZ2_bzDecompress(&stream_);
+
+    if (ret == BZ_STREAM_END) {
+      stream_end_ = true;
+    } else if (ret != BZ_OK) {
+      std::string msg("Error: Failed to decompress bzip2 input");
+      throw ReadBufferException(msg);
+    }
+  }
+
+  return len - stream_.avail_out;
+}
+#endif
+
+#ifdef BIOIO_HAVE_LZMA
+XzSource::XzSource(std::unique_ptr<InputSource> source,
+                   const size_t threads) :
+  source_(std::move(source)),
+  buffer_(new uint8_t[XzSource::kBufferSize]),
+  stream_(),
+  eof_(false),
+  stream_end_(false),
+  threads_(0)
+{
+  lzma_stream init = LZMA_STREAM_INIT;
+  lzma_ret    ret;
+
+  stream_ = init;
+
+#if LZMA_VERSION >= 50040002
+  // Multi-threaded decoding was stabilised in liblzma 5.4.0.
+  lzma_mt mt = lzma_mt();
+
+  mt.flags              = LZMA_CONCATENATED;
+  mt.threads            = threads ? threads : lzma_cputhreads();
+  mt.memlimit_threading = lzma_physmem() / 4;
+  mt.memlimit_stop      = UINT64_MAX;
+
+  ret = lzma_stream_decoder_mt(&stream_, &mt);
+
+  threads_ = mt.threads;
+#else
+  (void) threads;
+
+  ret = lzma_stream_decoder(&stream_, UINT64_MAX, LZMA_CONCATENATED);
+#endif
+
+  if (ret != LZMA_OK) {
+    delete[] buffer_;
+
+    std::string msg("Error: Failed to initialise xz decompression");
+    throw ReadBufferException(msg);
+  }
+}
+
+XzSource::~XzSource() {
+  lzma_end(&stream_);
+  delete[] buffer_;
+}
+
+size_t XzSource::Read(char *dst, size_t len) {
+  stream_.next_out  = reinterpret_cast<uint8_t *>(dst);
+  stream_.avail_out = len;
+
+  while (stream_.avail_out > 0 && !stream_end_) {
+    if (stream_.avail_in == 0 && !eof_) {
+      size_t size = source_->Read(reinterpret_cast<char *>(buffer_),
+                                  XzSource::kBufferSize);
+
+      eof_             = (size == 0);
+      stream_.next_in  = buffer_;
+      stream_.avail_in = size;
+    }
+
+    lzma_ret ret = lzma_code(&stream_, eof_ ? LZMA_FINISH : LZMA_RUN);
+
+    if (ret == LZMA_STREAM_END) {
+      stream_end_ = true;
+    } else if (ret == LZMA_BUF_ERROR && eof_) {
+      std::string msg("Error: Unexpected end of xz compressed input");
+      throw ReadBufferException(msg);
+    } else if (ret != LZMA_OK) {
+      std::string msg("Error: Failed to decompress xz input");
+      throw ReadBufferException(msg);
+    }
+  }
+
+  return len - stream_.avail_out;
+}
+
+size_t XzSource::Threads() const {
+  return threads_;
+}
+#endif
+
+#ifdef BIOIO_HAVE_ZSTD
+ZstdSource::ZstdSource(std::unique_ptr<InputSource> source,
+                       const size_t threads) :
+  source_(std::move(source)),
+  pool_(threads),
+  pending_(),
+  input_(),
+  input_pos_(0),
+  eof_(false),
+  frame_(),
+  frame_pos_(0),
+  error_(),
+  stream_(ZSTD_createDStream()),
+  streaming_(false),
+  stream_next_(false)
+{
+  if (!stream_) {
+    std::string msg("Error: Failed to initialise zstd decompression");
+    throw ReadBufferException(msg);
+  }
+}
+
+ZstdSource::~ZstdSource() {
+  ZSTD_freeDStream(stream_);
+}
+
+size_t ZstdSource::Read(char *dst, size_t len) {
+  size_t size = 0;
+
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+
+  while (size < len) {
+    if (frame_pos_ < frame_.size()) {
+      size_t chunk = std::min(len - size, frame_.size() - frame_pos_);
+
+      memcpy(dst + size, frame_.data() + frame_pos_, chunk);
+
+      size       += chunk;
+      frame_pos_ += chunk;
+
+      continue;
+    }
+
+    if (streaming_) {
+      size += StreamFrame(dst + size, len - size);
+
+      continue;
+    }
+
+    FillPending();
+
+    if (!pending_.empty()) {
+      std::future<std::string> next = std::move(pending_.front());
+
+      pending_.pop_front();
+
+      try {
+        frame_ = next.get();
+      } catch (...) {
+        error_ = std::current_exception();
+        throw;
+      }
+
+      frame_pos_ = 0;
+    } else if (stream_next_) {
+      ZSTD_DCtx_reset(stream_, ZSTD_reset_session_only);
+
+      streaming_   = true;
+      stream_next_ = false;
+    } else {
+      break;
+    }
+  }
+
+  return size;
+}
+
+bool ZstdSource::Refill() {
+  if (eof_) {
+    return false;
+  }
+
+  // Drop consumed input before growing the buffer.
+  if (input_pos_ > 0) {
+    input_.erase(0, input_pos_);
+    input_pos_ = 0;
+  }
+
+  size_t size = input_.size();
+
+  input_.resize(size + ZstdSource::kBufferSize);
+
+  size_t chunk = ReadFully(*source_, &input_[size], ZstdSource::kBufferSize);
+
+  input_.resize(size + chunk);
+
+  eof_ = (chunk == 0);
+
+  return !eof_;
+}
+
+bool ZstdSource::Available(size_t len) {
+  while (input_.size() - input_pos_ < len) {
+    if (!Refill()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t ZstdSource::Threads() const {
+  return pool_.size();
+}
+
+void ZstdSource::FillPending() {
+  static const size_t kSkippableHeaderSize = 8;
+  static const size_t kMaxFrameHeaderSize  = 18;
+
+  while (!stream_next_ &&
+         pending_.size() < pool_.size() * ZstdSource::kFramesPerThread) {
+    if (!Available(kMaxFrameHeaderSize) && input_pos_ == input_.size()) {
+      return;
+    }
+
+    const unsigned char *header =
+      reinterpret_cast<const unsigned char *>(input_.data()) + input_pos_;
+    size_t available = input_.size() - input_pos_;
+
+    // Skip skippable frames holding their size after the magic number.
+    if (available >= 4 && (header[0] & 0xf0) == 0x50 && header[1] == 0x2a &&
+        header[2] == 0x4d && header[3] == 0x18) {
+      if (!Available(kSkippableHeaderSize)) {
+        std::string msg("Error: Unexpected end of zstd compressed input");
+        throw ReadBufferException(msg);
+      }
+
+      header = reinterpret_cast<const unsigned char *>(input_.data()) +
+               input_pos_;
+
+      size_t frame_size = kSkippableHeaderSize +
+        (header[4] | (header[5] << 8) | (header[6] << 16) |
+         (static_cast<uint32_t>(header[7]) << 24));
+
+      if (!Available(frame_size)) {
+        std::string msg("Error: Unexpected end of zstd compressed input");
+        throw ReadBufferException(msg);
+      }
+
+      input_pos_ += frame_size;
+
+      continue;
+    }
+
+    unsigned long long content_size =
+      ZSTD_getFrameContentSize(header, available);
+
+    if (content_size == ZSTD_CONTENTSIZE_ERROR) {
+      std::string msg("Error: Failed to decompress zstd input");
+      throw ReadBufferException(msg);
+    }
+
+    if (content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        content_size > ZstdSource::kMaxFrameSize) {
+      stream_next_ = true;
+
+      return;
+    }
+
+    // Buffer the complete frame to hand it to the pool.
+    size_t frame_size;
+
+    while (ZSTD_isError(frame_size = ZSTD_findFrameCompressedSize(
+               input_.data() + input_pos_, input_.size() - input_pos_))) {
+      if (!Refill()) {
+        std::string msg("Error: Unexpected end of zstd compressed input");
+        throw ReadBufferException(msg);
+      }
+    }
+
+    auto frame = std::make_shared<std::string>(input_, input_pos_, frame_size);
+
+    input_pos_ += frame_size;
+
+    pending_.push_back(pool_.Submit([frame, content_size] {
+      std::string result(content_size, '\0');
+
+      size_t size = ZSTD_decompress(&result[0], result.size(),
+                                    frame->data(), frame->size());
+
+      if (ZSTD_isError(size) || size != content_size) {
+        std::string msg("Error: Failed to decompress zstd input");
+        throw ReadBufferException(msg);
+      }
+
+      return result;
+    }));
+  }
+}
+
+size_t ZstdSource::StreamFrame(char *dst, size_t len) {
+  ZSTD_outBuffer out = { dst, len, 0 };
+
+  while (out.pos < out.size) {
+    if (input_pos_ == input_.size() && !Refill()) {
+      std::string msg("Error: Unexpected end of zstd compressed input");
+      throw ReadBufferException(msg);
+    }
+
+    ZSTD_inBuffer in = { input_.data(), input_.size(), input_pos_ };
+
+    size_t ret = ZSTD_decompressStream(stream_, &out, &in);
+
+    input_pos_ = in.pos;
+
+    if (ZSTD_isError(ret)) {
+      std::string msg("Error: Failed to decompress zstd input");
+      throw ReadBufferException(msg);
+    }
+
+    // The frame is complete and fully flushed.
+    if (ret == 0) {
+      streaming_ = false;
+      break;
+    }
+  }
+
+  return out.pos;
+}
+#endif
+
+size_t ReadFully(InputSource &source, char *dst, size_t len) {
+  size_t size = 0;
+  size_t chunk;
+
+  while (size < len && (chunk = source.Read(dst + size, len - size)) > 0) {
+    size += chunk;
+  }
+
+  return size;
+}
+
+std::unique_ptr<InputSource> OpenInputSource(const std::string &file,
+                                             const size_t threads,
+                                             Compression &compression) {
+  std::unique_ptr<StreamSource> stream(new StreamSource(file));
+
+  char   magic[kMagicSize];
+  size_t size = stream->Peek(magic, sizeof(magic));
+
+  compression = DetectCompression(magic, size);
+
+  switch (compression) {
+    case Compression::gzip:
+      return std::unique_ptr<InputSource>(new GzipSource(std::move(stream)));
+    case Compression::bgzf:
+      return std::unique_ptr<InputSource>(new BgzfSource(std::move(stream),
+                                                         threads));
+#ifdef BIOIO_HAVE_BZIP2
+    case Compression::bzip2:
+      return std::unique_ptr<InputSource>(new Bzip2Source(std::move(stream)));
+#endif
+#ifdef BIOIO_HAVE_LZMA
+    case Compression::xz:
+      return std::unique_ptr<InputSource>(new XzSource(std::move(stream),
+                                                       threads));
+#endif
+#ifdef BIOIO_HAVE_ZSTD
+    case Compression::zstd:
+      return std::unique_ptr<InputSource>(new ZstdSource(std::move(stream),
+                                                         threads));
+#endif
+    case Compression::none:
+      break;
+    default: {
+      std::string msg("Error: BioIO was built without support for the "
+                      "compression format of file: " + file);
+      throw ReadBufferException(msg);
+    }
+  }
+
+  std::unique_ptr<InputSource> source(std::move(stream));
+
+  return source;
+}
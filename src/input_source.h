@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_INPUT_SOURCE_H_
+#define BIOIO_INPUT_SOURCE_H_
+
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <future>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+#include <zlib.h>
+
+#ifdef BIOIO_HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+#ifdef BIOIO_HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#ifdef BIOIO_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "thread_pool.h"
+
+/*
+ * Compression formats recognised by their magic bytes. Formats whose library
+ * was not found when BioIO was built are recognised but cannot be read.
+ */
+enum class Compression {
+  none,
+  gzip,
+  bgzf,
+  bzip2,
+  xz,
+  zstd
+};
+
+/*
+ * Number of leading chars needed to detect the compression format.
+ */
+static const size_t kMagicSize = 16;
+
+/*
+ * Return the compression format of data starting with the len chars given.
+ */
+Compression DetectCompression(const char *data, size_t len);
+
+/*
+ * Source of raw chars that ReadBuffer loads its buffers from.
+ */
+class InputSource
+{
+ public:
+  virtual ~InputSource() {}
+
+  /*
+   * Read up to len chars into dst and return the number of chars read. Only
+   * returns 0 at end-of-file.
+   */
+  virtual size_t Read(char *dst, size_t len) = 0;
+
+  /*
+   * Continue reading at the given byte offset. Throws unless the source
+   * supports seeking.
+   */
+  virtual void Seek(uint64_t offset);
+
+  /*
+   * Return the number of threads the source decompresses on besides the
+   * reading thread, which is 0 unless it runs a pool of its own.
+   */
+  virtual size_t Threads() const;
+};
+
+/*
+ * Source reading a file or standard input through an unbuffered stream.
+ */
+class StreamSource : public InputSource
+{
+ public:
+  StreamSource(const std::string &file);
+
+  size_t Read(char *dst, size_t len);
+
+  /*
+   * Read up to len chars into dst without consuming them, so they are
+   * returned again by the following Read calls.
+   */
+  size_t Peek(char *dst, size_t len);
+
+  /*
+   * Standard input cannot seek.
+   */
+  void Seek(uint64_t offset);
+
+ private:
+  /*
+   * Input stream of file being read.
+   */
+  std::ifstream input_stream_;
+
+  /*
+   * Stream being read, that is either input_stream_ or std::cin.
+   */
+  std::istream *input_;
+
+  /*
+   * Chars returned by Peek and not yet consumed by Read.
+   */
+  std::string peeked_;
+};
+
+/*
+ * Source inflating gzip (or zlib) compressed data from another source.
+ * Concatenated gzip members are inflated one after the other.
+ */
+class GzipSource : public InputSource
+{
+ public:
+  GzipSource(std::unique_ptr<InputSource> source);
+
+  ~GzipSource();
+
+  size_t Read(char *dst, size_t len);
+
+ private:
+  /*
+   * Size of the buffer holding compressed input.
+   */
+  static const auto kBufferSize = 256 * 1024;
+
+  /*
+   * Compressed input.
+   */
+  std::unique_ptr<InputSource> source_;
+
+  /*
+   * Buffer holding compressed input.
+   */
+  char *buffer_;
+
+  /*
+   * Inflate state.
+   */
+  z_stream stream_;
+
+  /*
+   * Tells if the compressed input is exhausted.
+   */
+  bool eof_;
+
+  /*
+   * Tells if the current gzip member has been fully inflated.
+   */
+  bool member_end_;
+};
+
+/*
+ * Source inflating BGZF compressed data, that is gzip members of at most 64
+ * KiB holding their own size, as written by bgzip. The blocks are inflated
+ * concurrently on a thread pool and delivered in their original order.
+ */
+class BgzfSource : public InputSource
+{
+ public:
+  /*
+   * Inflate the blocks on the given number of threads, or one per hardware
+   * thread if threads is 0.
+   */
+  BgzfSource(std::unique_ptr<InputSource> source, const size_t threads);
+
+  size_t Read(char *dst, size_t len);
+
+  size_t Threads() const;
+
+  /*
+   * Read the next compressed block from source into block. Returns false at
+   * end-of-file.
+   */
+  static bool ReadBlock(InputSource &source, std::string &block);
+
+  /*
+   * Inflate a compressed block and verify its size and CRC32.
+   */
+  static std::string InflateBlock(const std::string &block);
+
+ private:
+  /*
+   * Number of blocks queued per thread.
+   */
+  static const auto kBlocksPerThread = 4;
+
+  /*
+   * Maximum size of a block, compressed or inflated.
+   */
+  static const size_t kMaxBlockSize = 64 * 1024;
+
+  /*
+   * Compressed input.
+   */
+  std::unique_ptr<InputSource> source_;
+
+  /*
+   * Threads inflating the blocks.
+   */
+  ThreadPool pool_;
+
+  /*
+   * Blocks being inflated in input order.
+   */
+  std::deque<std::future<std::string>> pending_;
+
+  /*
+   * Inflated block being read and the position in it.
+   */
+  std::string block_;
+  size_t block_pos_;
+
+  /*
+   * Tells if the compressed input is exhausted.
+   */
+  bool eof_;
+
+  /*
+   * Error from a decompression task, rethrown by every later Read.
+   */
+  std::exception_ptr error_;
+
+  /*
+   * Queue compressed blocks until the pool is saturated or the input ends.
+   */
+  void FillPending();
+};
+
+#ifdef BIOIO_HAVE_BZIP2
+/*
+ * Source decompressing bzip2 data from another source. Concatenated streams,
+ * as written by pbzip2, are decompressed one after the other.
+ */
+class Bzip2Source : public InputSource
+{
+ public:
+  Bzip2Source(std::unique_ptr<InputSource> source);
+
+  ~Bzip2Source();
+
+  size_t Read(char *dst, size_t len);
+
+ private:
+  /*
+   * Size of the buffer holding compressed input.
+   */
+  static const auto kBufferSize = 256 * 1024;
+
+  /*
+   * Compressed input.
+   */
+  std::unique_ptr<InputSource> source_;
+
+  /*
+   * Buffer holding compressed input.
+   */
+  char *buffer_;
+
+  /*
+   * Decompression state.
+   */
+  bz_stream stream_;
+
+  /*
+   * Tells if the compressed input is exhausted.
+   */
+  bool eof_;
+
+  /*
+   * Tells if the current stream has been fully decompressed.
+   */
+  bool stream_end_;
+};
+#endif
+
+#ifdef BIOIO_HAVE_LZMA
+/*
+ * Source decompressing xz data from another source. Concatenated streams are
+ * decompressed one after the other, and with liblzma 5.4 or later the blocks
+ * of multi-block files are decompressed on several threads.
+ */
+class XzSource : public InputSource
+{
+ public:
+  XzSource(std::unique_ptr<InputSource> source, const size_t threads);
+
+  ~XzSource();
+
+  size_t Read(char *dst, size_t len);
+
+  size_t Threads() const;
+
+ private:
+  /*
+   * Size of the buffer holding compressed input.
+   */
+  static const auto kBufferSize = 256 * 1024;
+
+  /*
+   * Compressed input.
+   */
+  std::unique_ptr<InputSource> source_;
+
+  /*
+   * Buffer holding compressed input.
+   */
+  uint8_t *buffer_;
+
+  /*
+   * Decompression state.
+   */
+  lzma_stream stream_;
+
+  /*
+   * Tells if the compressed input is exhausted.
+   */
+  bool eof_;
+
+  /*
+   * Tells if all streams have been fully decompressed.
+   */
+  bool stream_end_;
+
+  /*
+   * Threads of the multi-threaded decoder, or 0 without one.
+   */
+  size_t threads_;
+};
+#endif
+
+#ifdef BIOIO_HAVE_ZSTD
+/*
+ * Source decompressing Zstandard data from another source. Frames that
+ * declare a content size of at most kMaxFrameSize, as written by zstd -T or
+ * pzstd, are decompressed concurrently on a thread pool and delivered in
+ * input order. Larger frames and frames of unknown size are streamed.
+ */
+class ZstdSource : public InputSource
+{
+ public:
+  /*
+   * Decompress the frames on the given number of threads, or one per
+   * hardware thread if threads is 0.
+   */
+  ZstdSource(std::unique_ptr<InputSource> source, const size_t threads);
+
+  ~ZstdSource();
+
+  size_t Read(char *dst, size_t len);
+
+  size_t Threads() const;
+
+ private:
+  /*
+   * Size of chunks read from the compressed input.
+   */
+  static const auto kBufferSize = 256 * 1024;
+
+  /*
+   * Largest frame content size decompressed in one piece on the pool.
+   */
+  static const auto kMaxFrameSize = 32 * 1024 * 1024;
+
+  /*
+   * Number of frames queued per thread.
+   */
+  static const auto kFramesPerThread = 2;
+
+  /*
+   * Compressed input.
+   */
+  std::unique_ptr<InputSource> source_;
+
+  /*
+   * Threads decompressing the frames.
+   */
+  ThreadPool pool_;
+
+  /*
+   * Frames being decompressed in input order.
+   */
+  std::deque<std::future<std::string>> pending_;
+
+  /*
+   * Compressed input not yet consumed and the position in it.
+   */
+  std::string input_;
+  size_t input_pos_;
+
+  /*
+   * Tells if the compressed input is exhausted.
+   */
+  bool eof_;
+
+  /*
+   * Decompressed frame being read and the position in it.
+   */
+  std::string frame_;
+  size_t frame_pos_;
+
+  /*
+   * Error from a decompression task, rethrown by every later Read.
+   */
+  std::exception_ptr error_;
+
+  /*
+   * Context for streaming frames too large for the pool.
+   */
+  ZSTD_DStream *stream_;
+
+  /*
+   * Tells if a frame is being streamed.
+   */
+  bool streaming_;
+
+  /*
+   * Tells if the frame at input_pos_ must be streamed.
+   */
+  bool stream_next_;
+
+  /*
+   * Append a chunk of compressed input to input_. Returns false at
+   * end-of-file.
+   */
+  bool Refill();
+
+  /*
+   * Make sure at least len chars of compressed input are available after
+   * input_pos_. Returns false if the input ends first.
+   */
+  bool Available(size_t len);
+
+  /*
+   * Queue complete frames on the pool until it is saturated, the input ends
+   * or a frame must be streamed.
+   */
+  void FillPending();
+
+  /*
+   * Stream the current frame into dst. Returns the number of chars written.
+   */
+  size_t StreamFrame(char *dst, size_t len);
+};
+#endif
+
+/*
+ * Read exactly len chars from source into dst unless end-of-file is reached
+ * first. Returns the number of chars read.
+ */
+size_t ReadFully(InputSource &source, char *dst, size_t len);
+
+/*
+ * Open file for streaming and wrap it in a decompressing source if its magic
+ * bytes tell that it is compressed. Parallel decompressors use the given
+ * number of threads, or one per hardware thread if threads is 0.
+ */
+std::unique_ptr<InputSource> OpenInputSource(const std::string &file,
+                                             const size_t threads,
+                                             Compression &compression);
+
+#endif  // BIOIO_INPUT_SOURCE_H_
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/packed_seq.h>
+#include <BioIO/simd.h>
+
+#include <algorithm>
+
+namespace {
+
+/*
+ * Copy bits bits of src starting at bit begin to the start of dst, which
+ * holds the (bits + 63) / 64 words, and clear the bits past them.
+ */
+void CopyBits(const std::vector<uint64_t> &src, const size_t begin,
+              const size_t bits, std::vector<uint64_t> &dst) {
+  size_t first = begin / 64;
+  size_t shift = begin % 64;
+
+  for (size_t j = 0; j < dst.size(); ++j) {
+    uint64_t word = src[first + j] >> shift;
+
+    if (shift && first + j + 1 < src.size()) {
+      word |= src[first + j + 1] << (64 - shift);
+    }
+
+    dst[j] = word;
+  }
+
+  if (bits % 64) {
+    dst.back() &= (uint64_t(1) << (bits % 64)) - 1;
+  }
+}
+
+}  // namespace
+
+PackedSeq::PackedSeq() :
+  size_(0),
+  words_(),
+  mask_()
+{}
+
+PackedSeq::PackedSeq(const std::string &seq) :
+  PackedSeq(seq.data(), seq.size())
+{}
+
+PackedSeq::PackedSeq(const char *seq, const size_t size) :
+  PackedSeq()
+{
+  Assign(seq, size);
+}
+
+void PackedSeq::Assign(const char *seq, const size_t size) {
+  size_ = size;
+  words_.resize((size + 31) / 32);
+  mask_.resize((size + 63) / 64);
+
+  if (size == 0) {
+    return;
+  }
+
+  Simd::Pack2Bit(seq, size, words_.data(), mask_.data());
+
+  // Drop the mask when no base is flagged, which is the common case.
+  for (const auto word : mask_) {
+    if (word) {
+      return;
+    }
+  }
+
+  mask_.clear();
+}
+
+std::string PackedSeq::Unpack() const {
+  std::string seq;
+
+  Unpack(seq);
+
+  return seq;
+}
+
+void PackedSeq::Unpack(std::string &seq) const {
+  seq.resize(size_);
+
+  if (size_ == 0) {
+    return;
+  }
+
+  Simd::Unpack2Bit(words_.data(), mask_.empty() ? nullptr : mask_.data(),
+                   size_, &seq[0]);
+}
+
+size_t PackedSeq::size() const {
+  return size_;
+}
+
+bool PackedSeq::empty() const {
+  return size_ == 0;
+}
+
+void PackedSeq::clear() {
+  size_ = 0;
+  words_.clear();
+  mask_.clear();
+}
+
+char PackedSeq::operator[](const size_t i) const {
+  if (masked(i)) {
+    return 'N';
+  }
+
+  return "ACGT"[(words_[i / 32] >> (2 * (i % 32))) & 3];
+}
+
+bool PackedSeq::masked(const size_t i) const {
+  return !mask_.empty() && ((mask_[i / 64] >> (i % 64)) & 1);
+}
+
+bool PackedSeq::masked(const size_t i, const size_t len) const {
+  if (mask_.empty()) {
+    return false;
+  }
+
+  for (size_t j = i; j < i + len; ) {
+    uint64_t word = mask_[j / 64] >> (j % 64);
+    size_t   bits = std::min(64 - j % 64, i + len - j);
+
+    if (bits < 64) {
+      word &= (uint64_t(1) << bits) - 1;
+    }
+
+    if (word) {
+      return true;
+    }
+
+    j += bits;
+  }
+
+  return false;
+}
+
+uint64_t PackedSeq::Kmer(const size_t i, const size_t k) const {
+  if (k > kBasesPerWord) {
+    std::string msg = "Error: k-mer longer than " +
+                      std::to_string(kBasesPerWord) + " bases: " +
+                      std::to_string(k);
+    throw PackedSeqException(msg);
+  }
+
+  if (i + k > size_) {
+    std::string msg = "Error: k-mer out of range: " + std::to_string(i) +
+                      " + " + std::to_string(k) + " > " +
+                      std::to_string(size_);
+    throw PackedSeqException(msg);
+  }
+
+  if (k == 0) {
+    return 0;
+  }
+
+  size_t   shift = 2 * (i % 32);
+  uint64_t kmer  = words_[i / 32] >> shift;
+
+  // Take the rest from the next word when the k-mer straddles two.
+  if (i % 32 + k > 32) {
+    kmer |= words_[i / 32 + 1] << (64 - shift);
+  }
+
+  if (k < kBasesPerWord) {
+    kmer &= (uint64_t(1) << (2 * k)) - 1;
+  }
+
+  return kmer;
+}
+
+PackedSeq PackedSeq::SubSeq(const size_t i, const size_t len) const {
+  if (i + len > size_) {
+    std::string msg = "Error: Subsequence out of range: " + std::to_string(i) +
+                      " + " + std::to_string(len) + " > " +
+                      std::to_string(size_);
+    throw PackedSeqException(msg);
+  }
+
+  PackedSeq sub;
+
+  sub.size_ = len;
+  sub.words_.resize((len + 31) / 32);
+
+  CopyBits(words_, 2 * i, 2 * len, sub.words_);
+
+  if (!mask_.empty()) {
+    sub.mask_.resize((len + 63) / 64);
+
+    CopyBits(mask_, i, len, sub.mask_);
+
+    // Drop the mask if no flagged base is in the slice.
+    if (std::all_of(sub.mask_.begin(), sub.mask_.end(),
+                    [](const uint64_t word) { return word == 0; })) {
+      sub.mask_.clear();
+    }
+  }
+
+  return sub;
+}
+
+const std::vector<uint64_t> &PackedSeq::words() const {
+  return words_;
+}
+
+const std::vector<uint64_t> &PackedSeq::mask() const {
+  return mask_;
+}
+
+bool PackedSeq::operator==(const PackedSeq &other) const {
+  return size_ == other.size_ && words_ == other.words_ &&
+         mask_ == other.mask_;
+}
+
+bool PackedSeq::operator!=(const PackedSeq &other) const {
+  return !(*this == other);
+}
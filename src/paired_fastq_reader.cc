@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/paired_fastq_reader.h>
+
+#include <algorithm>
+
+#include "chunk_reader.h"
+#include "chunk_pipeline.h"
+#include "thread_pool.h"
+
+PairedFastqReader::PairedFastqReader(const std::string &file1,
+                                     const std::string &file2,
+                                     const bool prefetch,
+                                     const int encoding,
+                                     const size_t batch_size) :
+  reader1_(new FastqReader(file1, encoding)),
+  reader2_(new FastqReader(file2, encoding)),
+  pipeline_(),
+  batch_size_(batch_size),
+  pairs_(0),
+  next1_(),
+  next2_(),
+  done1_(),
+  done2_(),
+  current1_(),
+  current2_(),
+  current_pos_(0),
+  error_(),
+  pool_()
+{
+  if (batch_size_ == 0) {
+    std::string msg = "Error: Batch size must be positive";
+    throw PairedFastqReaderException(msg);
+  }
+
+  if (prefetch) {
+    pool_.reset(new ThreadPool(2));
+
+    Prefetch();
+  }
+}
+
+PairedFastqReader::PairedFastqReader(const std::string &file,
+                                     const size_t threads,
+                                     const int encoding,
+                                     const size_t chunk_size) :
+  reader1_(),
+  reader2_(),
+  pipeline_(),
+  batch_size_(0),
+  pairs_(0),
+  next1_(),
+  next2_(),
+  done1_(),
+  done2_(),
+  current1_(),
+  current2_(),
+  current_pos_(0),
+  error_(),
+  pool_()
+{
+  pipeline_.reset(new ChunkPipeline(file, threads, chunk_size,
+                                    FindInterleavedFastqCut,
+                                    [encoding](const char *chunk, size_t size,
+                                               SeqBatch &batch1,
+                                               SeqBatch &batch2) {
+                                      ParseInterleaved(chunk, size, batch1,
+                                                       batch2, encoding);
+                                    },
+                                    true));
+}
+
+PairedFastqReader::~PairedFastqReader()
+{}
+
+void PairedFastqReader::Prefetch() {
+  done1_ = pool_->Submit([this] {
+    return reader1_->NextBatch(next1_, batch_size_);
+  });
+
+  done2_ = pool_->Submit([this] {
+    return reader2_->NextBatch(next2_, batch_size_);
+  });
+}
+
+size_t PairedFastqReader::NextBatch(SeqBatch &batch1, SeqBatch &batch2) {
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+
+  try {
+    return ReadBatch(batch1, batch2);
+  } catch (...) {
+    error_ = std::current_exception();
+    throw;
+  }
+}
+
+size_t PairedFastqReader::ReadBatch(SeqBatch &batch1, SeqBatch &batch2) {
+  size_t n1;
+  size_t n2;
+  size_t first = 0;
+
+  if (pipeline_) {
+    n1 = pipeline_->NextBatch(batch1, batch2);
+    n2 = batch2.size();
+
+    if (n1 > 0) {
+      first = n1 - 1;
+    }
+  } else if (pool_) {
+    if (!done1_.valid()) {
+      return 0;
+    }
+
+    // Let both workers finish before an error from either is rethrown, so
+    // no task is left running on the readers.
+    done1_.wait();
+    done2_.wait();
+
+    n1 = done1_.get();
+    n2 = done2_.get();
+
+    std::swap(batch1, next1_);
+    std::swap(batch2, next2_);
+
+    if (n1 > 0 && n2 > 0) {
+      Prefetch();
+    }
+  } else {
+    n1 = reader1_->NextBatch(batch1, batch_size_);
+    n2 = reader2_->NextBatch(batch2, batch_size_);
+  }
+
+  CheckMates(batch1, n1, batch2, n2, first);
+
+  pairs_ += n1;
+
+  return n1;
+}
+
+PairedFastqReader::EntryPair PairedFastqReader::NextEntry() {
+  if (!HasNextEntry()) {
+    std::string msg = "Error: no more entries";
+    throw PairedFastqReaderException(msg);
+  }
+
+  EntryPair pair;
+
+  pair.first.reset(new SeqEntry(current1_.Entry(current_pos_)));
+  pair.second.reset(new SeqEntry(current2_.Entry(current_pos_)));
+
+  ++current_pos_;
+
+  return pair;
+}
+
+bool PairedFastqReader::HasNextEntry() {
+  if (current_pos_ < current1_.size()) {
+    return true;
+  }
+
+  current_pos_ = 0;
+
+  return NextBatch(current1_, current2_) > 0;
+}
+
+CharSpan PairedFastqReader::MateName(const CharSpan &name) {
+  return ::MateName(name);
+}
+
+void PairedFastqReader::CheckMates(const SeqBatch &batch1, const size_t n1,
+                                   const SeqBatch &batch2, const size_t n2,
+                                   const size_t first) {
+  if (n1 != n2) {
+    std::string msg = "Error: Paired files differ in length after " +
+                      std::to_string(pairs_ + std::min(n1, n2)) + " pairs";
+    throw PairedFastqReaderException(msg);
+  }
+
+  for (size_t i = first; i < n1; ++i) {
+    if (!MatesMatch(batch1.name(i), batch2.name(i))) {
+      std::string msg = "Error: Mate names differ at pair " +
+                        std::to_string(pairs_ + i + 1) + ": " +
+                        std::string(batch1.name(i).data, batch1.name(i).size) +
+                        " != " +
+                        std::string(batch2.name(i).data, batch2.name(i).size);
+      throw PairedFastqReaderException(msg);
+    }
+  }
+}
+
+void PairedFastqReader::ParseInterleaved(const char *chunk, size_t size,
+                                         SeqBatch &batch1, SeqBatch &batch2,
+                                         const int encoding) {
+  FastqReader reader(chunk, size, encoding);
+
+  batch1.clear();
+  batch2.clear();
+  batch1.set_type(SeqEntry::SeqType::nucleotide);
+  batch2.set_type(SeqEntry::SeqType::nucleotide);
+
+  while (reader.AppendEntry(batch1)) {
+    size_t pair = batch1.size() - 1;
+
+    if (!reader.AppendEntry(batch2)) {
+      std::string msg = "Error: Interleaved input ends with an unpaired mate: " +
+                        batch1.name(pair).str();
+      throw PairedFastqReaderException(msg);
+    }
+
+    if (!MatesMatch(batch1.name(pair), batch2.name(pair))) {
+      break;
+    }
+  }
+}
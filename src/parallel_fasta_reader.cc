@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/parallel_fasta_reader.h>
+
+#include <limits>
+
+#include "chunk_reader.h"
+#include "chunk_pipeline.h"
+
+namespace {
+
+/*
+ * Parse a chunk of FASTA records into batch.
+ */
+void ParseFasta(const char *chunk, size_t size, SeqBatch &batch,
+                const SeqEntry::SeqType type) {
+  FastaReader reader(chunk, size);
+
+  reader.set_type(type);
+
+  reader.NextBatch(batch, std::numeric_limits<size_t>::max());
+}
+
+}  // namespace
+
+ParallelFastaReader::ParallelFastaReader(const std::string &file,
+                                         const size_t threads,
+                                         const Delivery delivery,
+                                         const size_t chunk_size,
+                                         const SeqEntry::SeqType type) :
+  pipeline_(),
+  current_(),
+  current_pos_(0)
+{
+  using namespace std::placeholders;
+
+  ChunkPipeline::ParseFunc parse = std::bind(ParseFasta, _1, _2, _3, type);
+
+  pipeline_.reset(new ChunkPipeline(file, threads, chunk_size, FindFastaCut,
+                                    parse, delivery == Delivery::ordered));
+}
+
+ParallelFastaReader::~ParallelFastaReader()
+{}
+
+size_t ParallelFastaReader::NextBatch(SeqBatch &batch) {
+  return pipeline_->NextBatch(batch);
+}
+
+std::unique_ptr<SeqEntry> ParallelFastaReader::NextEntry() {
+  if (!HasNextEntry()) {
+    std::string msg = "Error: no more entries";
+    throw FastaReaderException(msg);
+  }
+
+  return std::unique_ptr<SeqEntry>(new SeqEntry(current_.Entry(current_pos_++)));
+}
+
+bool ParallelFastaReader::HasNextEntry() {
+  if (current_pos_ < current_.size()) {
+    return true;
+  }
+
+  current_pos_ = 0;
+
+  return NextBatch(current_) > 0;
+}
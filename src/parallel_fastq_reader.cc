@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/parallel_fastq_reader.h>
+
+#include <limits>
+
+#include "chunk_reader.h"
+#include "chunk_pipeline.h"
+
+namespace {
+
+/*
+ * Parse a chunk of FASTQ records into batch.
+ */
+void ParseFastq(const char *chunk, size_t size, SeqBatch &batch,
+                const int encoding) {
+  FastqReader reader(chunk, size, encoding);
+
+  reader.NextBatch(batch, std::numeric_limits<size_t>::max());
+}
+
+}  // namespace
+
+ParallelFastqReader::ParallelFastqReader(const std::string &file,
+                                         const size_t threads,
+                                         const int encoding,
+                                         const size_t chunk_size) :
+  pipeline_(),
+  current_(),
+  current_pos_(0)
+{
+  using namespace std::placeholders;
+
+  ChunkPipeline::ParseFunc parse = std::bind(ParseFastq, _1, _2, _3,
+                                             encoding);
+
+  pipeline_.reset(new ChunkPipeline(file, threads, chunk_size, FindFastqCut,
+                                    parse, true));
+}
+
+ParallelFastqReader::~ParallelFastqReader()
+{}
+
+size_t ParallelFastqReader::NextBatch(SeqBatch &batch) {
+  return pipeline_->NextBatch(batch);
+}
+
+std::unique_ptr<SeqEntry> ParallelFastqReader::NextEntry() {
+  if (!HasNextEntry()) {
+    std::string msg = "Error: no more entries";
+    throw FastqReaderException(msg);
+  }
+
+  return std::unique_ptr<SeqEntry>(new SeqEntry(current_.Entry(current_pos_++)));
+}
+
+bool ParallelFastqReader::HasNextEntry() {
+  if (current_pos_ < current_.size()) {
+    return true;
+  }
+
+  current_pos_ = 0;
+
+  return NextBatch(current_) > 0;
+}
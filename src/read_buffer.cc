@@ -19,66 +19,433 @@
  */
 
 #include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <utility>
+#include <system_error>
 #include <BioIO/read_buffer.h>
+#include <BioIO/simd.h>
 
-ReadBuffer::ReadBuffer(const size_t buffer_size, const std::string &file) :
+#include "input_source.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BIOIO_HAVE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+const std::string ReadBuffer::kStdin = "-";
+
+ReadBuffer::ReadBuffer(const size_t buffer_size, const std::string &file,
+                       const Mode mode, const size_t threads) :
   buffer_size_(buffer_size),
-  input_stream_(),
-  buffer_(new char[buffer_size]),
+  source_(),
+  compressed_(false),
+  buffer_(nullptr),
+  map_(nullptr),
+  map_size_(0),
+  data_(nullptr),
+  data_size_(0),
   buffer_pos_(0),
-  file_size_()
+  buffer_offset_(0),
+  input_size_(0),
+  back_buffer_(nullptr),
+  back_size_(0),
+  back_ready_(false),
+  back_error_(),
+  stop_(false),
+  read_ahead_(),
+  mutex_(),
+  cond_()
 {
-  input_stream_.rdbuf()->pubsetbuf(0, 0);
-  input_stream_.open(file, std::ifstream::in);
+  GetInputSize(file);
+
+  if ((mode == Mode::automatic || mode == Mode::mmap) && MapFile(file)) {
+    if (DetectCompression(data_, data_size_) == Compression::none) {
+      return;
+    }
 
-  if (!input_stream_.good()) {
-    std::string msg("Error: File not found or not readable: " + file);
+    UnmapFile();
+
+    if (mode == Mode::mmap) {
+      std::string msg("Error: Compressed file cannot be memory mapped: " + file);
+      throw ReadBufferException(msg);
+    }
+  }
+
+  if (mode == Mode::mmap) {
+    std::string msg("Error: File could not be memory mapped: " + file);
     throw ReadBufferException(msg);
   }
 
-  GetFileSize();
-  LoadBuffer();
+  OpenStream(file, threads);
+
+  // The first buffer is loaded by the first read, so read errors are thrown
+  // from there rather than from the constructor.
+  if (mode != Mode::stream) {
+    StartReadAhead();
+  }
 }
 
+ReadBuffer::ReadBuffer(const char *data, const size_t size) :
+  buffer_size_(size),
+  source_(),
+  compressed_(false),
+  buffer_(nullptr),
+  map_(nullptr),
+  map_size_(0),
+  data_(data),
+  data_size_(size),
+  buffer_pos_(0),
+  buffer_offset_(0),
+  input_size_(size),
+  back_buffer_(nullptr),
+  back_size_(0),
+  back_ready_(false),
+  back_error_(),
+  stop_(false),
+  read_ahead_(),
+  mutex_(),
+  cond_()
+{}
+
 ReadBuffer::~ReadBuffer() {
-  input_stream_.close();
+  StopReadAhead();
+  UnmapFile();
+  delete[] buffer_;
+  delete[] back_buffer_;
 }
 
-void ReadBuffer::GetFileSize() {
-  input_stream_.seekg(0, input_stream_.end);
-  file_size_ = input_stream_.tellg();
-  input_stream_.seekg(0, input_stream_.beg);
+void ReadBuffer::GetInputSize(const std::string &file) {
+#ifdef BIOIO_HAVE_MMAP
+  struct stat st;
+
+  if (file != kStdin && stat(file.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+    input_size_ = st.st_size;
+  }
+#else
+  (void) file;
+#endif
 }
 
-void ReadBuffer::LoadBuffer() {
-  input_stream_.read(buffer_, buffer_size_);
+bool ReadBuffer::MapFile(const std::string &file) {
+#ifdef BIOIO_HAVE_MMAP
+  if (file == kStdin) {
+    return false;
+  }
+
+  int fd = open(file.c_str(), O_RDONLY);
 
-  buffer_pos_ = 0;
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+
+  // Files larger than the address space are streamed instead.
+  if (static_cast<uint64_t>(st.st_size) > SIZE_MAX) {
+    close(fd);
+    return false;
+  }
+
+  if (st.st_size > 0) {
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (map == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    map_      = map;
+    map_size_ = st.st_size;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+
+  data_      = static_cast<const char *>(map_);
+  data_size_ = map_size_;
+
+  return true;
+#else
+  (void) file;
+
+  return false;
+#endif
 }
 
-char ReadBuffer::NextChar() {
-  if (buffer_pos_ == buffer_size_) {
-    LoadBuffer();
+void ReadBuffer::UnmapFile() {
+#ifdef BIOIO_HAVE_MMAP
+  if (map_) {
+    munmap(map_, map_size_);
+  }
+#endif
+
+  map_       = nullptr;
+  map_size_  = 0;
+  data_      = nullptr;
+  data_size_ = 0;
+}
+
+void ReadBuffer::OpenStream(const std::string &file, const size_t threads) {
+  Compression compression;
+
+  source_     = OpenInputSource(file, threads, compression);
+  compressed_ = (compression != Compression::none);
+
+  if (compressed_) {
+    input_size_ = 0;
+  }
+
+  buffer_ = new char[buffer_size_];
+  data_   = buffer_;
+}
+
+bool ReadBuffer::StartReadAhead() {
+  back_buffer_ = new char[buffer_size_];
+
+  try {
+    read_ahead_ = std::thread(&ReadBuffer::ReadAhead, this);
+  } catch (const std::system_error &) {
+    delete[] back_buffer_;
+    back_buffer_ = nullptr;
+
+    return false;
+  }
+
+  return true;
+}
+
+void ReadBuffer::StopReadAhead() {
+  if (read_ahead_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+
+    cond_.notify_all();
+    read_ahead_.join();
+  }
+}
+
+void ReadBuffer::ReadAhead() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    cond_.wait(lock, [this] { return stop_ || !back_ready_; });
+
+    if (stop_) {
+      return;
+    }
+
+    lock.unlock();
+
+    size_t             size = 0;
+    std::exception_ptr error;
+
+    try {
+      size = ReadInput(back_buffer_);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+
+    back_size_  = size;
+    back_error_ = error;
+    back_ready_ = true;
+
+    cond_.notify_all();
+
+    if (size == 0) {
+      return;
+    }
+  }
+}
+
+size_t ReadBuffer::ReadInput(char *dst) {
+  if (!source_) {
+    return 0;
+  }
+
+  return source_->Read(dst, buffer_size_);
+}
+
+bool ReadBuffer::LoadBuffer() {
+  size_t size;
+
+  if (back_buffer_) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    cond_.wait(lock, [this] { return back_ready_; });
+
+    if (back_error_) {
+      std::rethrow_exception(back_error_);
+    }
+
+    // Leave the empty buffer ready so later calls also see end-of-file.
+    if (back_size_ == 0) {
+      return false;
+    }
+
+    std::swap(buffer_, back_buffer_);
+
+    size        = back_size_;
+    back_ready_ = false;
+
+    lock.unlock();
+    cond_.notify_all();
+  } else if ((size = ReadInput(buffer_)) == 0) {
+    return false;
   }
 
-  if (file_size_-- == 0)
+  buffer_offset_ += data_size_;
+  data_           = buffer_;
+  data_size_      = size;
+  buffer_pos_     = 0;
+
+  return true;
+}
+
+char ReadBuffer::NextChar() {
+  if (buffer_pos_ == data_size_ && !LoadBuffer())
     return '\0';
 
-  return buffer_[buffer_pos_++];
+  return data_[buffer_pos_++];
 }
 
 char ReadBuffer::PrevChar() {
   if (buffer_pos_ <= 1)
     return '\0';
 
-  return buffer_[buffer_pos_ - 2];
+  return data_[buffer_pos_ - 2];
 }
 
 void ReadBuffer::Rewind(size_t len) {
   buffer_pos_ -= len;
-  file_size_  += len;
 }
 
 bool ReadBuffer::Eof() {
-  return file_size_ <= 0;
+  return buffer_pos_ == data_size_ && !LoadBuffer();
+}
+
+const char *ReadBuffer::Peek(size_t &len) {
+  if (buffer_pos_ == data_size_ && !LoadBuffer()) {
+    len = 0;
+
+    return nullptr;
+  }
+
+  len = data_size_ - buffer_pos_;
+
+  return data_ + buffer_pos_;
+}
+
+void ReadBuffer::Skip(size_t len) {
+  buffer_pos_ += len;
+}
+
+const char *ReadBuffer::LineSpan(size_t &len, bool &eol) {
+  const char *begin = Peek(len);
+
+  if (!begin) {
+    eol = false;
+
+    return nullptr;
+  }
+
+  const char *end = Simd::FindEol(begin, begin + len);
+
+  eol = (end != begin + len);
+  len = end - begin;
+
+  return begin;
+}
+
+void ReadBuffer::SkipEol() {
+  if (NextChar() == '\r') {
+    size_t      len;
+    const char *next = Peek(len);
+
+    if (next && *next == '\n') {
+      Skip(1);
+    }
+  }
+}
+
+void ReadBuffer::Seek(uint64_t offset) {
+  // Mapped and in-memory data is held whole.
+  if (!source_) {
+    if (offset > data_size_) {
+      std::string msg("Error: Seek past end of input");
+      throw ReadBufferException(msg);
+    }
+
+    buffer_pos_ = offset;
+
+    return;
+  }
+
+  if (compressed_) {
+    std::string msg("Error: Compressed input cannot seek");
+    throw ReadBufferException(msg);
+  }
+
+  // The read-ahead thread is stopped while the source is moved and then
+  // restarted to fill the back buffer from the new offset.
+  bool restart = read_ahead_.joinable();
+
+  StopReadAhead();
+
+  source_->Seek(offset);
+
+  buffer_offset_ = offset;
+  data_size_     = 0;
+  buffer_pos_    = 0;
+  back_size_     = 0;
+  back_ready_    = false;
+  back_error_    = nullptr;
+  stop_          = false;
+
+  if (restart) {
+    try {
+      read_ahead_ = std::thread(&ReadBuffer::ReadAhead, this);
+    } catch (const std::system_error &) {
+      delete[] back_buffer_;
+      back_buffer_ = nullptr;
+    }
+  }
+}
+
+bool ReadBuffer::mapped() const {
+  return map_ != nullptr;
+}
+
+bool ReadBuffer::async() const {
+  return back_buffer_ != nullptr;
+}
+
+bool ReadBuffer::compressed() const {
+  return compressed_;
+}
+
+size_t ReadBuffer::decompress_threads() const {
+  return source_ ? source_->Threads() : 0;
+}
+
+uint64_t ReadBuffer::Offset() const {
+  return buffer_offset_ + buffer_pos_;
+}
+
+uint64_t ReadBuffer::Size() const {
+  return input_size_;
 }
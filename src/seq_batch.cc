@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/seq_batch.h>
+
+SeqBatch::SeqBatch() :
+  names_(),
+  seqs_(),
+  scores_(),
+  name_offsets_(1, 0),
+  seq_offsets_(1, 0),
+  score_offsets_(1, 0),
+  type_(SeqEntry::SeqType::nucleotide)
+{}
+
+size_t SeqBatch::size() const {
+  return name_offsets_.size() - 1;
+}
+
+bool SeqBatch::empty() const {
+  return size() == 0;
+}
+
+void SeqBatch::clear() {
+  names_.clear();
+  seqs_.clear();
+  scores_.clear();
+
+  name_offsets_.resize(1);
+  seq_offsets_.resize(1);
+  score_offsets_.resize(1);
+}
+
+void SeqBatch::reserve(size_t records, size_t chars, size_t bases) {
+  names_.reserve(chars);
+  seqs_.reserve(bases);
+  scores_.reserve(bases);
+
+  name_offsets_.reserve(records + 1);
+  seq_offsets_.reserve(records + 1);
+  score_offsets_.reserve(records + 1);
+}
+
+uint8_t *SeqBatch::Append(const CharSpan &name, const CharSpan &seq,
+                          const size_t scores_size) {
+  names_.append(name.data, name.size);
+  seqs_.append(seq.data, seq.size);
+  scores_.resize(scores_.size() + scores_size);
+
+  name_offsets_.push_back(names_.size());
+  seq_offsets_.push_back(seqs_.size());
+  score_offsets_.push_back(scores_.size());
+
+  return scores_.data() + scores_.size() - scores_size;
+}
+
+CharSpan SeqBatch::name(const size_t i) const {
+  return CharSpan(names_.data() + name_offsets_[i],
+                  name_offsets_[i + 1] - name_offsets_[i]);
+}
+
+CharSpan SeqBatch::seq(const size_t i) const {
+  return CharSpan(seqs_.data() + seq_offsets_[i],
+                  seq_offsets_[i + 1] - seq_offsets_[i]);
+}
+
+const uint8_t *SeqBatch::scores(const size_t i, size_t &len) const {
+  len = score_offsets_[i + 1] - score_offsets_[i];
+
+  return scores_.data() + score_offsets_[i];
+}
+
+SeqEntry SeqBatch::Entry(const size_t i) const {
+  size_t         len;
+  const uint8_t *data = scores(i, len);
+
+  return SeqEntry(name(i).str(), seq(i).str(),
+                  std::vector<uint8_t>(data, data + len), type_);
+}
+
+SeqEntry::SeqType SeqBatch::type() const {
+  return type_;
+}
+
+void SeqBatch::set_type(const SeqEntry::SeqType type) {
+  type_ = type;
+}
+
+const std::string &SeqBatch::names() const {
+  return names_;
+}
+
+const std::string &SeqBatch::seqs() const {
+  return seqs_;
+}
+
+const std::vector<uint8_t> &SeqBatch::all_scores() const {
+  return scores_;
+}
+
+const std::vector<size_t> &SeqBatch::name_offsets() const {
+  return name_offsets_;
+}
+
+const std::vector<size_t> &SeqBatch::seq_offsets() const {
+  return seq_offsets_;
+}
+
+const std::vector<size_t> &SeqBatch::score_offsets() const {
+  return score_offsets_;
+}
@@ -19,11 +19,13 @@
  */
 
 #include <BioIO/seq_entry.h>
+#include <BioIO/simd.h>
 
 #include <ostream>
 #include <algorithm>
 
 SeqEntry::SeqEntry(SeqEntry::SeqType sequence_type) :
+  score_encoding_(0),
   type_(sequence_type)
 {}
 
@@ -34,20 +36,27 @@ SeqEntry::SeqEntry(const std::string& name,
   name_(name),
   seq_(sequence),
   scores_(scores),
+  score_encoding_(0),
   type_(sequence_type)
 {}
 
 SeqEntry::SeqEntry(const SeqEntry& other) :
   name_(other.name_),
   seq_(other.seq_),
+  packed_seq_(other.packed_seq_),
   scores_(other.scores_),
+  raw_scores_(other.raw_scores_),
+  score_encoding_(other.score_encoding_),
   type_(other.type_)
 {}
 
-SeqEntry::SeqEntry(SeqEntry&& other) :
+SeqEntry::SeqEntry(SeqEntry&& other) noexcept :
   name_(std::move(other.name_)),
   seq_(std::move(other.seq_)),
+  packed_seq_(std::move(other.packed_seq_)),
   scores_(std::move(other.scores_)),
+  raw_scores_(std::move(other.raw_scores_)),
+  score_encoding_(other.score_encoding_),
   type_(std::move(other.type_))
 {}
 
@@ -56,33 +65,83 @@ SeqEntry::~SeqEntry() {
 
 SeqEntry& SeqEntry::operator=(const SeqEntry& other) {
   if(this != &other) {
-    name_   = other.name_;
-    seq_    = other.seq_;
-    scores_ = other.scores_;
-    type_   = other.type_;
+    name_           = other.name_;
+    seq_            = other.seq_;
+    packed_seq_     = other.packed_seq_;
+    scores_         = other.scores_;
+    raw_scores_     = other.raw_scores_;
+    score_encoding_ = other.score_encoding_;
+    type_           = other.type_;
   }
   return *this;
 }
 
 SeqEntry SeqEntry::SubSeq(size_t i, size_t len) const {
-  if (!scores_.empty()) {
-    std::vector<uint8_t>::const_iterator first = scores_.begin() + i;
-    std::vector<uint8_t>::const_iterator last = first + len;
-    std::vector<uint8_t> newScores(first, last);
+  SeqEntry entry(type_);
 
-    return SeqEntry(name_, seq_.substr(i, len), newScores, type_);
+  entry.name_ = name_;
+
+  if (packed()) {
+    entry.packed_seq_ = packed_seq_.SubSeq(i, len);
   } else {
-    return SeqEntry(name_, seq_.substr(i, len), scores_, type_);
+    entry.seq_ = seq_.substr(i, len);
+  }
+
+  // Raw scores stay raw in the subsequence.
+  if (!raw_scores_.empty()) {
+    entry.raw_scores_     = raw_scores_.substr(i, len);
+    entry.score_encoding_ = score_encoding_;
+  } else if (!scores_.empty()) {
+    entry.scores_.assign(scores_.begin() + i, scores_.begin() + i + len);
   }
+
+  return entry;
 }
 
 size_t SeqEntry::Size() {
-  return seq_.size();
+  return seq_.size() + packed_seq_.size();
+}
+
+void SeqEntry::Pack() {
+  CheckPackable();
+
+  if (!packed()) {
+    packed_seq_.Assign(seq_.data(), seq_.size());
+
+    // Release the unpacked sequence to save the memory.
+    std::string().swap(seq_);
+  }
+}
+
+void SeqEntry::Unpack() {
+  if (packed()) {
+    packed_seq_.Unpack(seq_);
+    packed_seq_ = PackedSeq();
+  }
+}
+
+void SeqEntry::CheckPackable() const {
+  if (type_ != SeqType::nucleotide) {
+    std::string msg = "Error: Only nucleotide sequences can be packed";
+    throw SeqEntryException(msg);
+  }
+}
+
+bool SeqEntry::packed() const {
+  return !packed_seq_.empty();
 }
 
 void SeqEntry::reverse() {
-  std::reverse(seq_.begin(), seq_.end());
+  if (packed()) {
+    Unpack();
+    std::reverse(seq_.begin(), seq_.end());
+    Pack();
+  } else {
+    std::reverse(seq_.begin(), seq_.end());
+  }
+
   std::reverse(scores_.begin(), scores_.end());
+  std::reverse(raw_scores_.begin(), raw_scores_.end());
 }
 
 std::string& SeqEntry::name() {
@@ -101,14 +160,34 @@ const std::string& SeqEntry::seq() const {
   return seq_;
 }
 
+PackedSeq& SeqEntry::packed_seq() {
+  return packed_seq_;
+}
+
+const PackedSeq& SeqEntry::packed_seq() const {
+  return packed_seq_;
+}
+
 std::vector<uint8_t>& SeqEntry::scores() {
+  if (!raw_scores_.empty()) {
+    DecodeScores();
+  }
+
   return scores_;
 }
 
 const std::vector<uint8_t>& SeqEntry::scores() const {
+  if (!raw_scores_.empty()) {
+    DecodeScores();
+  }
+
   return scores_;
 }
 
+const std::string& SeqEntry::raw_scores() const {
+  return raw_scores_;
+}
+
 SeqEntry::SeqType SeqEntry::type() const {
   return type_;
 }
@@ -119,16 +198,56 @@ void SeqEntry::set_name(const std::string& name) {
 
 void SeqEntry::set_seq(const std::string& sequence) {
   seq_ = sequence;
+  packed_seq_.clear();
+}
+
+void SeqEntry::set_packed_seq(const char* sequence, size_t size) {
+  CheckPackable();
+
+  seq_.clear();
+  packed_seq_.Assign(sequence, size);
 }
 
 void SeqEntry::set_scores(const std::vector<uint8_t>& scores) {
   scores_ = scores;
+  raw_scores_.clear();
+}
+
+void SeqEntry::set_raw_scores(const char* scores, size_t size,
+                              uint8_t encoding) {
+  scores_.clear();
+  raw_scores_.assign(scores, size);
+  score_encoding_ = encoding;
 }
 
 void SeqEntry::set_type(SeqType type) {
   type_ = type;
 }
 
+void SeqEntry::DecodeScores() const {
+  scores_.resize(raw_scores_.size());
+
+  if (!Simd::DecodeScores(raw_scores_.data(), raw_scores_.size(),
+                          score_encoding_, scores_.data())) {
+    for (const char c : raw_scores_) {
+      unsigned char score = c;
+
+      if (score < score_encoding_ || score > 126) {
+        std::string msg = "Error: Score char " + std::to_string(score) +
+                          " out of range for encoding " +
+                          std::to_string(score_encoding_);
+        throw SeqEntryException(msg);
+      }
+    }
+  }
+
+  raw_scores_.clear();
+}
+
 std::ostream& operator<< (std::ostream& o, const SeqEntry& sequence) {
+  if (sequence.packed()) {
+    return o << '>' << sequence.name_ << '\n' << sequence.packed_seq_.Unpack();
+  }
+
   return o << '>' << sequence.name_ << '\n' << sequence.seq_;
 }
@@ -0,0 +1,683 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <BioIO/simd.h>
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define BIOIO_SIMD_X86
+#include <immintrin.h>
+#define BIOIO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/*
+ * Kernels selected for one instruction set level.
+ */
+struct SimdKernels {
+  Simd::Level level;
+  const char *(*find_eol)(const char *begin, const char *end);
+  const char *(*find_non_seq)(const char *begin, const char *end);
+  void (*pack_2bit)(const char *seq, size_t size, uint64_t *words,
+                    uint64_t *mask);
+  void (*unpack_2bit)(const uint64_t *words, const uint64_t *mask,
+                      size_t size, char *seq);
+  bool (*decode_scores)(const char *src, size_t size, uint8_t offset,
+                        uint8_t *scores);
+  void (*min_max)(const char *begin, const char *end, uint8_t &min,
+                  uint8_t &max);
+};
+
+/*
+ * Highest encoded score char.
+ */
+static const uint8_t kMaxScoreChar = 126;
+
+/*
+ * 2-bit code of each char, or 4 for chars other than ACGT.
+ */
+struct PackTable {
+  uint8_t codes[256];
+
+  PackTable() {
+    memset(codes, 4, sizeof(codes));
+
+    codes['A'] = codes['a'] = 0;
+    codes['C'] = codes['c'] = 1;
+    codes['G'] = codes['g'] = 2;
+    codes['T'] = codes['t'] = 3;
+  }
+};
+
+static const PackTable kPackTable;
+
+static inline bool IsEol(const char c) {
+  return (c == '\n') || (c == '\r');
+}
+
+static inline bool IsNonSeq(const char c) {
+  return (c < 33) || (c > 126);
+}
+
+static const char *FindEolScalar(const char *begin, const char *end) {
+  while (begin < end && !IsEol(*begin)) {
+    ++begin;
+  }
+
+  return begin;
+}
+
+static const char *FindNonSeqScalar(const char *begin, const char *end) {
+  while (begin < end && !IsNonSeq(*begin)) {
+    ++begin;
+  }
+
+  return begin;
+}
+
+/*
+ * Pack the bases from position begin to size, which may start part way
+ * through a word, on top of words and mask cleared from begin.
+ */
+static void Pack2BitTail(const char *seq, size_t begin, size_t size,
+                         uint64_t *words, uint64_t *mask) {
+  for (size_t i = begin; i < size; ++i) {
+    uint8_t code = kPackTable.codes[static_cast<unsigned char>(seq[i])];
+
+    if (code > 3) {
+      mask[i / 64] |= uint64_t(1) << (i % 64);
+    } else {
+      words[i / 32] |= uint64_t(code) << (2 * (i % 32));
+    }
+  }
+}
+
+/*
+ * Clear the words and mask words from the ones holding base begin.
+ */
+static void ClearPacked(size_t begin, size_t size, uint64_t *words,
+                        uint64_t *mask) {
+  memset(words + begin / 32, 0, ((size + 31) / 32 - begin / 32) * 8);
+  memset(mask + begin / 64, 0, ((size + 63) / 64 - begin / 64) * 8);
+}
+
+static void Pack2BitScalar(const char *seq, size_t size, uint64_t *words,
+                           uint64_t *mask) {
+  ClearPacked(0, size, words, mask);
+  Pack2BitTail(seq, 0, size, words, mask);
+}
+
+/*
+ * Unpack the bases from position begin to size.
+ */
+static void Unpack2BitTail(const uint64_t *words, const uint64_t *mask,
+                           size_t begin, size_t size, char *seq) {
+  for (size_t i = begin; i < size; ++i) {
+    if (mask && (mask[i / 64] >> (i % 64)) & 1) {
+      seq[i] = 'N';
+    } else {
+      seq[i] = "ACGT"[(words[i / 32] >> (2 * (i % 32))) & 3];
+    }
+  }
+}
+
+static void Unpack2BitScalar(const uint64_t *words, const uint64_t *mask,
+                             size_t size, char *seq) {
+  Unpack2BitTail(words, mask, 0, size, seq);
+}
+
+static bool DecodeScoresScalar(const char *src, size_t size, uint8_t offset,
+                               uint8_t *scores) {
+  // Scores below offset wrap around and so also exceed limit.
+  const uint8_t limit = kMaxScoreChar - offset;
+  uint8_t       bad   = 0;
+
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t score = static_cast<uint8_t>(src[i]) - offset;
+
+    bad      |= (score > limit);
+    scores[i] = score;
+  }
+
+  return !bad;
+}
+
+static void MinMaxScalar(const char *begin, const char *end, uint8_t &min,
+                         uint8_t &max) {
+  for (; begin < end; ++begin) {
+    uint8_t c = static_cast<uint8_t>(*begin);
+
+    min = (c < min) ? c : min;
+    max = (c > max) ? c : max;
+  }
+}
+
+#ifdef BIOIO_SIMD_X86
+BIOIO_TARGET("sse2")
+static const char *FindEolSse2(const char *begin, const char *end) {
+  const __m128i nl = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+
+  for (; begin + 16 <= end; begin += 16) {
+    __m128i v    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr));
+    int     mask = _mm_movemask_epi8(hits);
+
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+
+  return FindEolScalar(begin, end);
+}
+
+BIOIO_TARGET("sse2")
+static const char *FindNonSeqSse2(const char *begin, const char *end) {
+  // Chars 128-255 are negative as signed bytes and so also below 33.
+  const __m128i low = _mm_set1_epi8(33);
+  const __m128i del = _mm_set1_epi8(127);
+
+  for (; begin + 16 <= end; begin += 16) {
+    __m128i v    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    __m128i hits = _mm_or_si128(_mm_cmpgt_epi8(low, v), _mm_cmpeq_epi8(v, del));
+    int     mask = _mm_movemask_epi8(hits);
+
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+
+  return FindNonSeqScalar(begin, end);
+}
+
+/*
+ * Pack the 16 bases in v into 32 bits of codes and set the bits of invalid
+ * for the chars other than ACGT.
+ */
+BIOIO_TARGET("sse2")
+static inline uint32_t Pack16Sse2(__m128i v, uint32_t &invalid) {
+  // Bits 1-2 of A, C, G and T in either case are 0, 1, 3 and 2, which
+  // xor-ing bit 1 into bit 0 turns into 0-3.
+  const __m128i three = _mm_set1_epi8(3);
+  const __m128i one   = _mm_set1_epi8(1);
+  __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  __m128i valid = _mm_or_si128(
+    _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('a')),
+                 _mm_cmpeq_epi8(lower, _mm_set1_epi8('c'))),
+    _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('g')),
+                 _mm_cmpeq_epi8(lower, _mm_set1_epi8('t'))));
+  __m128i c = _mm_and_si128(_mm_srli_epi16(v, 1), three);
+
+  c = _mm_xor_si128(c, _mm_and_si128(_mm_srli_epi16(c, 1), one));
+  c = _mm_and_si128(c, valid);
+
+  // Merge the codes of neighbouring bytes, 16-bit words and 32-bit words,
+  // leaving 16 bits of codes at the bottom of each 64-bit half.
+  c = _mm_and_si128(_mm_or_si128(c, _mm_srli_epi16(c, 6)),
+                    _mm_set1_epi16(0x000f));
+  c = _mm_and_si128(_mm_or_si128(c, _mm_srli_epi32(c, 12)),
+                    _mm_set1_epi32(0x00ff));
+  c = _mm_and_si128(_mm_or_si128(c, _mm_srli_epi64(c, 24)),
+                    _mm_set1_epi64x(0xffff));
+
+  invalid = ~_mm_movemask_epi8(valid) & 0xffff;
+
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(c)) |
+         static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(c, 8))) << 16;
+}
+
+BIOIO_TARGET("sse2")
+static void Pack2BitSse2(const char *seq, size_t size, uint64_t *words,
+                         uint64_t *mask) {
+  size_t i = 0;
+
+  ClearPacked(0, size, words, mask);
+
+  for (; i + 32 <= size; i += 32) {
+    uint32_t invalid_lo;
+    uint32_t invalid_hi;
+    uint64_t lo = Pack16Sse2(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(seq + i)), invalid_lo);
+    uint64_t hi = Pack16Sse2(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(seq + i + 16)),
+      invalid_hi);
+
+    words[i / 32]  = lo | (hi << 32);
+    mask[i / 64]  |= uint64_t(invalid_lo | (invalid_hi << 16)) << (i % 64);
+  }
+
+  Pack2BitTail(seq, i, size, words, mask);
+}
+
+/*
+ * Return 16 chars for 16 bases of codes with the bases set in flags as N.
+ */
+BIOIO_TARGET("sse2")
+static inline __m128i Unpack16Sse2(uint32_t codes, uint32_t flags) {
+  // Spread each byte of codes over four bytes and pick one base in each.
+  __m128i v = _mm_cvtsi32_si128(codes);
+
+  v = _mm_unpacklo_epi8(v, v);
+  v = _mm_unpacklo_epi16(v, v);
+  v = _mm_and_si128(v, _mm_set1_epi32(int(0xc0300c03)));
+
+  __m128i c = _mm_or_si128(
+    _mm_or_si128(
+      _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi32(0x40100401)),
+                    _mm_set1_epi8('C' - 'A')),
+      _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi32(int(0x80200802))),
+                    _mm_set1_epi8('G' - 'A'))),
+    _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi32(int(0xc0300c03))),
+                  _mm_set1_epi8('T' - 'A')));
+
+  c = _mm_add_epi8(c, _mm_set1_epi8('A'));
+
+  // Spread the low byte of flags over bytes 0-7 and the high byte over
+  // bytes 8-15 and pick one bit in each.
+  const __m128i bits = _mm_set1_epi64x(int64_t(0x8040201008040201));
+  __m128i       n    = _mm_cvtsi32_si128(flags);
+
+  n = _mm_unpacklo_epi8(n, n);
+  n = _mm_unpacklo_epi16(n, n);
+  n = _mm_unpacklo_epi32(n, n);
+  n = _mm_cmpeq_epi8(_mm_and_si128(n, bits), bits);
+
+  return _mm_or_si128(_mm_andnot_si128(n, c),
+                      _mm_and_si128(n, _mm_set1_epi8('N')));
+}
+
+BIOIO_TARGET("sse2")
+static void Unpack2BitSse2(const uint64_t *words, const uint64_t *mask,
+                           size_t size, char *seq) {
+  size_t i = 0;
+
+  for (; i + 32 <= size; i += 32) {
+    uint64_t codes = words[i / 32];
+    uint64_t flags = mask ? mask[i / 64] >> (i % 64) : 0;
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(seq + i),
+                     Unpack16Sse2(codes, flags & 0xffff));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(seq + i + 16),
+                     Unpack16Sse2(codes >> 32, (flags >> 16) & 0xffff));
+  }
+
+  Unpack2BitTail(words, mask, i, size, seq);
+}
+
+BIOIO_TARGET("sse2")
+static bool DecodeScoresSse2(const char *src, size_t size, uint8_t offset,
+                             uint8_t *scores) {
+  // A score is at most limit as an unsigned byte exactly when max(score,
+  // limit) is limit, so any other bits left in bad flag an invalid score.
+  const __m128i off   = _mm_set1_epi8(static_cast<char>(offset));
+  const __m128i limit = _mm_set1_epi8(static_cast<char>(kMaxScoreChar - offset));
+  __m128i       bad   = _mm_setzero_si128();
+  size_t        i     = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_sub_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), off);
+
+    bad = _mm_or_si128(bad, _mm_xor_si128(_mm_max_epu8(v, limit), limit));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(scores + i), v);
+  }
+
+  bool ok = _mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128())) ==
+            0xffff;
+
+  return DecodeScoresScalar(src + i, size - i, offset, scores + i) && ok;
+}
+
+BIOIO_TARGET("sse2")
+static void MinMaxSse2(const char *begin, const char *end, uint8_t &min,
+                       uint8_t &max) {
+  if (begin + 16 <= end) {
+    __m128i lo = _mm_set1_epi8(static_cast<char>(min));
+    __m128i hi = _mm_set1_epi8(static_cast<char>(max));
+
+    for (; begin + 16 <= end; begin += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+
+      lo = _mm_min_epu8(lo, v);
+      hi = _mm_max_epu8(hi, v);
+    }
+
+    alignas(16) char lanes[32];
+
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), lo);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes + 16), hi);
+
+    uint8_t ignore_max = 0;
+    uint8_t ignore_min = 255;
+
+    MinMaxScalar(lanes, lanes + 16, min, ignore_max);
+    MinMaxScalar(lanes + 16, lanes + 32, ignore_min, max);
+  }
+
+  MinMaxScalar(begin, end, min, max);
+}
+
+BIOIO_TARGET("avx2")
+static const char *FindEolAvx2(const char *begin, const char *end) {
+  const __m256i nl = _mm256_set1_epi8('\n');
+  const __m256i cr = _mm256_set1_epi8('\r');
+
+  for (; begin + 32 <= end; begin += 32) {
+    __m256i  v    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    __m256i  hits = _mm256_or_si256(_mm256_cmpeq_epi8(v, nl),
+                                    _mm256_cmpeq_epi8(v, cr));
+    unsigned mask = _mm256_movemask_epi8(hits);
+
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+
+  return FindEolSse2(begin, end);
+}
+
+BIOIO_TARGET("avx2")
+static const char *FindNonSeqAvx2(const char *begin, const char *end) {
+  const __m256i low = _mm256_set1_epi8(33);
+  const __m256i del = _mm256_set1_epi8(127);
+
+  for (; begin + 32 <= end; begin += 32) {
+    __m256i  v    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    __m256i  hits = _mm256_or_si256(_mm256_cmpgt_epi8(low, v),
+                                    _mm256_cmpeq_epi8(v, del));
+    unsigned mask = _mm256_movemask_epi8(hits);
+
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+
+  return FindNonSeqSse2(begin, end);
+}
+
+BIOIO_TARGET("avx2")
+static void Pack2BitAvx2(const char *seq, size_t size, uint64_t *words,
+                         uint64_t *mask) {
+  const __m256i three = _mm256_set1_epi8(3);
+  const __m256i one   = _mm256_set1_epi8(1);
+  size_t        i     = 0;
+
+  ClearPacked(0, size, words, mask);
+
+  // As Pack16Sse2 on 32 bases at a time.
+  for (; i + 32 <= size; i += 32) {
+    __m256i v     = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(seq + i));
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i valid = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('a')),
+                      _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('c'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('g')),
+                      _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('t'))));
+    __m256i c = _mm256_and_si256(_mm256_srli_epi16(v, 1), three);
+
+    c = _mm256_xor_si256(c, _mm256_and_si256(_mm256_srli_epi16(c, 1), one));
+    c = _mm256_and_si256(c, valid);
+    c = _mm256_and_si256(_mm256_or_si256(c, _mm256_srli_epi16(c, 6)),
+                         _mm256_set1_epi16(0x000f));
+    c = _mm256_and_si256(_mm256_or_si256(c, _mm256_srli_epi32(c, 12)),
+                         _mm256_set1_epi32(0x00ff));
+    c = _mm256_and_si256(_mm256_or_si256(c, _mm256_srli_epi64(c, 24)),
+                         _mm256_set1_epi64x(0xffff));
+
+    // Gather the 16 bits at the bottom of each 64-bit quarter.
+    alignas(32) uint64_t quarters[4];
+
+    _mm256_store_si256(reinterpret_cast<__m256i *>(quarters), c);
+
+    uint32_t invalid = ~static_cast<uint32_t>(_mm256_movemask_epi8(valid));
+
+    words[i / 32]  = quarters[0] | (quarters[1] << 16) |
+                     (quarters[2] << 32) | (quarters[3] << 48);
+    mask[i / 64]  |= uint64_t(invalid) << (i % 64);
+  }
+
+  Pack2BitTail(seq, i, size, words, mask);
+}
+
+BIOIO_TARGET("avx2")
+static void Unpack2BitAvx2(const uint64_t *words, const uint64_t *mask,
+                           size_t size, char *seq) {
+  const __m256i pick = _mm256_set1_epi32(int(0xc0300c03));
+  const __m256i bits = _mm256_set1_epi64x(int64_t(0x8040201008040201));
+  size_t        i    = 0;
+
+  // As Unpack16Sse2 on 32 bases at a time, spreading the bytes of codes
+  // and flags in each 128-bit half separately.
+  for (; i + 32 <= size; i += 32) {
+    uint64_t codes = words[i / 32];
+    uint64_t flags = mask ? mask[i / 64] >> (i % 64) : 0;
+
+    __m128i lo = _mm_cvtsi32_si128(static_cast<uint32_t>(codes));
+    __m128i hi = _mm_cvtsi32_si128(static_cast<uint32_t>(codes >> 32));
+
+    lo = _mm_unpacklo_epi16(_mm_unpacklo_epi8(lo, lo), _mm_unpacklo_epi8(lo, lo));
+    hi = _mm_unpacklo_epi16(_mm_unpacklo_epi8(hi, hi), _mm_unpacklo_epi8(hi, hi));
+
+    __m256i v = _mm256_and_si256(
+      _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), pick);
+
+    __m256i c = _mm256_or_si256(
+      _mm256_or_si256(
+        _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi32(0x40100401)),
+                         _mm256_set1_epi8('C' - 'A')),
+        _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi32(int(0x80200802))),
+                         _mm256_set1_epi8('G' - 'A'))),
+      _mm256_and_si256(_mm256_cmpeq_epi8(v, pick),
+                       _mm256_set1_epi8('T' - 'A')));
+
+    c = _mm256_add_epi8(c, _mm256_set1_epi8('A'));
+
+    if (static_cast<uint32_t>(flags)) {
+      __m128i nlo = _mm_cvtsi32_si128(static_cast<uint32_t>(flags) & 0xffff);
+      __m128i nhi = _mm_cvtsi32_si128(static_cast<uint32_t>(flags) >> 16);
+
+      nlo = _mm_unpacklo_epi8(nlo, nlo);
+      nlo = _mm_unpacklo_epi32(_mm_unpacklo_epi16(nlo, nlo),
+                               _mm_unpacklo_epi16(nlo, nlo));
+      nhi = _mm_unpacklo_epi8(nhi, nhi);
+      nhi = _mm_unpacklo_epi32(_mm_unpacklo_epi16(nhi, nhi),
+                               _mm_unpacklo_epi16(nhi, nhi));
+
+      __m256i n = _mm256_inserti128_si256(_mm256_castsi128_si256(nlo), nhi, 1);
+
+      n = _mm256_cmpeq_epi8(_mm256_and_si256(n, bits), bits);
+      c = _mm256_or_si256(_mm256_andnot_si256(n, c),
+                          _mm256_and_si256(n, _mm256_set1_epi8('N')));
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(seq + i), c);
+  }
+
+  Unpack2BitTail(words, mask, i, size, seq);
+}
+
+BIOIO_TARGET("avx2")
+static bool DecodeScoresAvx2(const char *src, size_t size, uint8_t offset,
+                             uint8_t *scores) {
+  const __m256i off   = _mm256_set1_epi8(static_cast<char>(offset));
+  const __m256i limit = _mm256_set1_epi8(static_cast<char>(kMaxScoreChar - offset));
+  __m256i       bad   = _mm256_setzero_si256();
+  size_t        i     = 0;
+
+  // As DecodeScoresSse2 on 32 scores at a time.
+  for (; i + 32 <= size; i += 32) {
+    __m256i v = _mm256_sub_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), off);
+
+    bad = _mm256_or_si256(bad,
+                          _mm256_xor_si256(_mm256_max_epu8(v, limit), limit));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(scores + i), v);
+  }
+
+  bool ok = _mm256_testz_si256(bad, bad);
+
+  return DecodeScoresSse2(src + i, size - i, offset, scores + i) && ok;
+}
+
+BIOIO_TARGET("avx2")
+static void MinMaxAvx2(const char *begin, const char *end, uint8_t &min,
+                       uint8_t &max) {
+  if (begin + 32 <= end) {
+    __m256i lo = _mm256_set1_epi8(static_cast<char>(min));
+    __m256i hi = _mm256_set1_epi8(static_cast<char>(max));
+
+    for (; begin + 32 <= end; begin += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+
+      lo = _mm256_min_epu8(lo, v);
+      hi = _mm256_max_epu8(hi, v);
+    }
+
+    alignas(32) char lanes[64];
+
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), lo);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes + 32), hi);
+
+    uint8_t ignore_max = 0;
+    uint8_t ignore_min = 255;
+
+    MinMaxScalar(lanes, lanes + 32, min, ignore_max);
+    MinMaxScalar(lanes + 32, lanes + 64, ignore_min, max);
+  }
+
+  MinMaxSse2(begin, end, min, max);
+}
+
+BIOIO_TARGET("avx512bw")
+static bool DecodeScoresAvx512(const char *src, size_t size, uint8_t offset,
+                               uint8_t *scores) {
+  const __m512i off   = _mm512_set1_epi8(static_cast<char>(offset));
+  const __m512i limit = _mm512_set1_epi8(static_cast<char>(kMaxScoreChar - offset));
+  __mmask64     bad   = 0;
+  size_t        i     = 0;
+
+  for (; i + 64 <= size; i += 64) {
+    __m512i v = _mm512_sub_epi8(_mm512_loadu_si512(src + i), off);
+
+    bad |= _mm512_cmpgt_epu8_mask(v, limit);
+    _mm512_storeu_si512(scores + i, v);
+  }
+
+  // Masked loads and stores are slower than the AVX2 kernel on the tail,
+  // which is most of a short read.
+  return DecodeScoresAvx2(src + i, size - i, offset, scores + i) && !bad;
+}
+#endif
+
+static SimdKernels KernelsFor(Simd::Level level) {
+  switch (level) {
+#ifdef BIOIO_SIMD_X86
+    case Simd::Level::avx512bw:
+      return { level, FindEolAvx2, FindNonSeqAvx2, Pack2BitAvx2,
+               Unpack2BitAvx2, DecodeScoresAvx512, MinMaxAvx2 };
+    case Simd::Level::avx2:
+      return { level, FindEolAvx2, FindNonSeqAvx2, Pack2BitAvx2,
+               Unpack2BitAvx2, DecodeScoresAvx2, MinMaxAvx2 };
+    case Simd::Level::sse2:
+      return { level, FindEolSse2, FindNonSeqSse2, Pack2BitSse2,
+               Unpack2BitSse2, DecodeScoresSse2, MinMaxSse2 };
+#endif
+    default:
+      return { Simd::Level::scalar, FindEolScalar, FindNonSeqScalar,
+               Pack2BitScalar, Unpack2BitScalar, DecodeScoresScalar,
+               MinMaxScalar };
+  }
+}
+
+static SimdKernels &ActiveKernels() {
+  static SimdKernels kernels = KernelsFor(Simd::MaxLevel());
+
+  return kernels;
+}
+
+Simd::Level Simd::level() {
+  return ActiveKernels().level;
+}
+
+Simd::Level Simd::MaxLevel() {
+#ifdef BIOIO_SIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512bw")) {
+    return Level::avx512bw;
+  }
+
+  if (__builtin_cpu_supports("avx2")) {
+    return Level::avx2;
+  }
+
+  if (__builtin_cpu_supports("sse2")) {
+    return Level::sse2;
+  }
+#endif
+
+  return Level::scalar;
+}
+
+void Simd::set_level(Level level) {
+  if (level > MaxLevel()) {
+    level = MaxLevel();
+  }
+
+  ActiveKernels() = KernelsFor(level);
+}
+
+const char *Simd::FindEol(const char *begin, const char *end) {
+  return ActiveKernels().find_eol(begin, end);
+}
+
+const char *Simd::FindNonSeq(const char *begin, const char *end) {
+  return ActiveKernels().find_non_seq(begin, end);
+}
+
+void Simd::Pack2Bit(const char *seq, size_t size, uint64_t *words,
+                    uint64_t *mask) {
+  // Empty input may come with null word and mask arrays.
+  if (size == 0) {
+    return;
+  }
+
+  ActiveKernels().pack_2bit(seq, size, words, mask);
+}
+
+void Simd::Unpack2Bit(const uint64_t *words, const uint64_t *mask,
+                      size_t size, char *seq) {
+  if (size == 0) {
+    return;
+  }
+
+  ActiveKernels().unpack_2bit(words, mask, size, seq);
+}
+
+bool Simd::DecodeScores(const char *src, size_t size, uint8_t offset,
+                        uint8_t *scores) {
+  return ActiveKernels().decode_scores(src, size, offset, scores);
+}
+
+void Simd::MinMax(const char *begin, const char *end, uint8_t &min,
+                  uint8_t &max) {
+  ActiveKernels().min_max(begin, end, min, max);
+}
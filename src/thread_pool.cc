@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t threads) :
+  workers_(),
+  tasks_(),
+  mutex_(),
+  cond_(),
+  stop_(false)
+{
+  if (threads == 0) {
+    threads = DefaultThreads();
+  }
+
+  try {
+    for (size_t i = 0; i < threads; ++i) {
+      workers_.push_back(std::thread(&ThreadPool::Work, this));
+    }
+  } catch (...) {
+    Stop();
+    throw;
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  Stop();
+}
+
+void ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  cond_.notify_all();
+
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::size() const {
+  return workers_.size();
+}
+
+size_t ThreadPool::DefaultThreads() {
+  size_t threads = std::thread::hardware_concurrency();
+
+  return threads ? threads : 1;
+}
+
+void ThreadPool::Work() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+
+    task();
+  }
+}
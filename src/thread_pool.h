@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_THREAD_POOL_H_
+#define BIOIO_THREAD_POOL_H_
+
+#include <queue>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <future>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+/*
+ * Fixed size pool of worker threads running submitted tasks in FIFO order.
+ * Results are delivered through futures, so callers keeping the futures in
+ * a queue get the results back in submission order.
+ */
+class ThreadPool
+{
+ public:
+  /*
+   * Start a pool with the given number of threads, or one per hardware
+   * thread if threads is 0.
+   */
+  ThreadPool(size_t threads);
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /*
+   * Finish the queued tasks and join the worker threads.
+   */
+  ~ThreadPool();
+
+  /*
+   * Queue task for execution and return a future for its result.
+   */
+  template <typename F>
+  std::future<typename std::result_of<F()>::type> Submit(F task) {
+    typedef typename std::result_of<F()>::type Result;
+
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(task);
+    auto future   = packaged->get_future();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push([packaged] { (*packaged)(); });
+    }
+
+    cond_.notify_one();
+
+    return future;
+  }
+
+  /*
+   * Return the number of worker threads.
+   */
+  size_t size() const;
+
+  /*
+   * Return the number of threads to use when 0 is requested.
+   */
+  static size_t DefaultThreads();
+
+ private:
+  /*
+   * Worker threads.
+   */
+  std::vector<std::thread> workers_;
+
+  /*
+   * Tasks waiting for a worker.
+   */
+  std::queue<std::function<void()>> tasks_;
+
+  /*
+   * Mutex and condition guarding tasks_ and stop_.
+   */
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  /*
+   * Tells the workers to stop once the queue is empty.
+   */
+  bool stop_;
+
+  /*
+   * Stop and join the worker threads.
+   */
+  void Stop();
+
+  /*
+   * Body of the worker threads.
+   */
+  void Work();
+};
+
+#endif  // BIOIO_THREAD_POOL_H_
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <fstream>
+#include "catch.hpp"
+#include <BioIO/bioio.h>
+
+namespace {
+
+std::string ReadFile(const std::string &file) {
+  std::ifstream input(file, std::ifstream::binary);
+
+  return std::string(std::istreambuf_iterator<char>(input),
+                     std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST_CASE("BgzfIndex is loaded from .gzi files", "[bgzf_index]") {
+  BgzfIndex index = BgzfIndex::Load("test/fasta_files/test12.fasta.bgz.gzi");
+
+  // The fixture holds 90 bytes in blocks of 16.
+  REQUIRE(index.size() == 6);
+  REQUIRE(index.blocks()[0].compressed_offset == 0);
+  REQUIRE(index.blocks()[0].uncompressed_offset == 0);
+  REQUIRE(index.blocks()[1].uncompressed_offset == 16);
+
+  REQUIRE(&index.Locate(0) == &index.blocks()[0]);
+  REQUIRE(&index.Locate(15) == &index.blocks()[0]);
+  REQUIRE(&index.Locate(16) == &index.blocks()[1]);
+  REQUIRE(&index.Locate(88) == &index.blocks()[5]);
+  REQUIRE(&index.Locate(1000) == &index.blocks()[5]);
+
+  SECTION("Built index matches the loaded index") {
+    BgzfIndex built = BgzfIndex::Build("test/fasta_files/test12.fasta.bgz");
+
+    REQUIRE(built.size() == index.size());
+
+    for (size_t i = 0; i < built.size(); ++i) {
+      REQUIRE(built.blocks()[i].compressed_offset ==
+              index.blocks()[i].compressed_offset);
+      REQUIRE(built.blocks()[i].uncompressed_offset ==
+              index.blocks()[i].uncompressed_offset);
+    }
+  }
+
+  SECTION("Saved index matches the .gzi file") {
+    index.Save("test12.gzi");
+
+    REQUIRE(ReadFile("test12.gzi") ==
+            ReadFile("test/fasta_files/test12.fasta.bgz.gzi"));
+
+    remove("test12.gzi");
+  }
+}
+
+TEST_CASE("BgzfIndex w. truncated .gzi file throws", "[bgzf_index]") {
+  std::string file = "truncated.gzi";
+
+  std::ofstream output(file, std::ofstream::binary);
+  output << ReadFile("test/fasta_files/test12.fasta.bgz.gzi").substr(0, 20);
+  output.close();
+
+  try {
+    BgzfIndex::Load(file);
+
+    FAIL("Index did not throw expected exception");
+  }
+  catch (BgzfIndexException& e) {
+    REQUIRE(e.exceptionMsg == "Error: malformed BGZF index file: truncated.gzi");
+  }
+
+  remove(file.c_str());
+}
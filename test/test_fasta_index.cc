@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <fstream>
+#include "catch.hpp"
+#include <BioIO/bioio.h>
+
+namespace {
+
+std::string ReadFile(const std::string &file) {
+  std::ifstream input(file);
+
+  return std::string(std::istreambuf_iterator<char>(input),
+                     std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST_CASE("FastaIndex is built like samtools faidx", "[fasta_index]") {
+  FastaIndex index = FastaIndex::Build("test/fasta_files/test12.fasta");
+
+  REQUIRE(index.size() == 3);
+
+  const FastaIndexEntry *chr1 = index.Find("chr1");
+  REQUIRE(chr1);
+  REQUIRE(chr1->length == 23);
+  REQUIRE(chr1->offset == 23);
+  REQUIRE(chr1->line_bases == 10);
+  REQUIRE(chr1->line_width == 11);
+
+  REQUIRE(index.Find("HLA-A*01:01"));
+  REQUIRE_FALSE(index.Find("chr3"));
+
+  REQUIRE(FastaIndex::BaseOffset(*chr1, 0) == 23);
+  REQUIRE(FastaIndex::BaseOffset(*chr1, 10) == 34);
+  REQUIRE(FastaIndex::BaseOffset(*chr1, 22) == 47);
+
+  SECTION("Saved index matches the samtools index") {
+    index.Save("test12.fasta.fai");
+
+    REQUIRE(ReadFile("test12.fasta.fai") ==
+            ReadFile("test/fasta_files/test12.fasta.fai"));
+
+    remove("test12.fasta.fai");
+  }
+
+  SECTION("Loaded index matches the built index") {
+    FastaIndex loaded = FastaIndex::Load("test/fasta_files/test12.fasta.fai");
+
+    REQUIRE(loaded.size() == 3);
+    REQUIRE(loaded.entries()[1].name == "chr2");
+    REQUIRE(loaded.entries()[1].length == 14);
+    REQUIRE(loaded.entries()[1].offset == 55);
+  }
+}
+
+TEST_CASE("FastaIndex w. Windows line-endings", "[fasta_index]") {
+  std::string file = "crlf.fasta";
+
+  std::ofstream output(file);
+  output << ">seq\r\nACGT\r\nACGT\r\nAC\r\n";
+  output.close();
+
+  FastaIndex index = FastaIndex::Build(file);
+
+  REQUIRE(index.size() == 1);
+  REQUIRE(index.entries()[0].length == 10);
+  REQUIRE(index.entries()[0].offset == 6);
+  REQUIRE(index.entries()[0].line_bases == 4);
+  REQUIRE(index.entries()[0].line_width == 6);
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastaIndex w. uneven line lengths throws", "[fasta_index]") {
+  std::string file = "uneven.fasta";
+
+  std::ofstream output(file);
+  output << ">seq" << std::endl << "ACGT" << std::endl << "AC" << std::endl
+         << "ACGT" << std::endl;
+  output.close();
+
+  try {
+    FastaIndex::Build(file);
+
+    FAIL("Index did not throw expected exception");
+  }
+  catch (FastaIndexException& e) {
+    REQUIRE(e.exceptionMsg == "Error: different line length in sequence: seq");
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastaIndex w. malformed index throws", "[fasta_index]") {
+  std::string file = "malformed.fai";
+
+  std::ofstream output(file);
+  output << "chr1\t23\t23" << std::endl;
+  output.close();
+
+  try {
+    FastaIndex::Load(file);
+
+    FAIL("Index did not throw expected exception");
+  }
+  catch (FastaIndexException& e) {
+    REQUIRE(e.exceptionMsg == "Error: malformed FASTA index line 1 in file: malformed.fai");
+  }
+
+  remove(file.c_str());
+}
@@ -20,7 +20,13 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <fstream>
+#include <sstream>
 #include "catch.hpp"
+#include "test_helpers.h"
 #include <BioIO/bioio.h>
 
 TEST_CASE("FastaReader w. OK entries", "[fasta_reader]") {
@@ -255,3 +261,303 @@ TEST_CASE("FastaReader w. non-FASTA content throws", "[fasta_reader]") {
     REQUIRE(e.exceptionMsg == "Error: File not in FASTA format");
   }
 }
+
+TEST_CASE("FastaReader w. long name and sequence", "[fasta_reader]") {
+  std::string file = "long.fasta";
+  std::string name(5000, 'n');
+  std::string seq(2000000, 'A');
+
+  std::ofstream output(file);
+
+  output << ">" << name << std::endl;
+
+  for (size_t i = 0; i < seq.size(); i += 60) {
+    output << seq.substr(i, 60) << std::endl;
+  }
+
+  output << ">short" << std::endl << "ATCG" << std::endl;
+  output.close();
+
+  FastaReader reader(file);
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry1 = reader.NextEntry();
+  REQUIRE(entry1->name() == name);
+  REQUIRE(entry1->seq() == seq);
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry2 = reader.NextEntry();
+  REQUIRE(entry2->name() == "short");
+  REQUIRE(entry2->seq() == "ATCG");
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastaReader views match entries", "[fasta_reader]") {
+  std::string file  = "views.fasta";
+  size_t      count = 50000;
+
+  std::ostringstream output;
+
+  for (size_t i = 0; i < count; ++i) {
+    std::string eol = (i % 7 == 0) ? "\r\n" : "\n";
+
+    output << ">seq" << i << eol << std::string(1 + i % 90, "ACGT"[i % 4]);
+
+    if (i % 3 == 0)
+      output << eol << "NNNN";
+
+    output << eol;
+  }
+
+  CheckPlainAndGzip(file, output.str(), [&] {
+    FastaReader entries(file);
+    FastaReader views(file);
+
+    size_t n = 0;
+
+    while (views.HasNextEntry()) {
+      SeqView view = views.NextView();
+
+      if (!entries.HasNextEntry())
+        break;
+
+      auto entry = entries.NextEntry();
+
+      if (view.name.str() != entry->name() || view.seq.str() != entry->seq())
+        break;
+
+      ++n;
+    }
+
+    REQUIRE(n == count);
+    REQUIRE_FALSE(entries.HasNextEntry());
+  });
+}
+
+TEST_CASE("FastaReader w. chunks", "[fasta_reader]") {
+  std::string file = "chunks.fasta";
+
+  std::vector<std::string> names;
+  std::vector<std::string> seqs;
+  std::ostringstream       output;
+
+  // The longest record spans several read buffers of compressed input.
+  for (size_t length : {1, 9, 10, 11, 100, 700001}) {
+    std::string name = "seq" + std::to_string(length);
+    std::string seq;
+    std::string eol  = (length % 2) ? "\r\n" : "\n";
+
+    for (size_t i = 0; i < length; ++i) {
+      seq += "ACGT"[(i * 7 + i / 5) % 4];
+    }
+
+    output << ">" << name << eol;
+
+    for (size_t i = 0; i < seq.size(); i += 60) {
+      output << seq.substr(i, 60) << eol;
+    }
+
+    output << eol;
+
+    names.push_back(name);
+    seqs.push_back(seq);
+  }
+
+  CheckPlainAndGzip(file, output.str(), [&] {
+    for (auto sizes : {std::make_pair(10, 0), std::make_pair(10, 3),
+                       std::make_pair(7, 6), std::make_pair(1000000, 30)}) {
+      size_t size    = sizes.first;
+      size_t overlap = sizes.second;
+
+      FastaReader reader(file);
+      SeqChunk    chunk;
+
+      std::vector<std::string> result_names;
+      std::vector<std::string> result_seqs;
+      bool                     chunks_ok = true;
+
+      while (reader.NextChunk(chunk, size, overlap)) {
+        if (chunk.offset == 0) {
+          result_names.push_back(chunk.name);
+          result_seqs.push_back(chunk.seq);
+        } else {
+          std::string &seq = result_seqs.back();
+
+          chunks_ok = chunks_ok && chunk.name == result_names.back() &&
+                      chunk.offset == seq.size() - overlap &&
+                      seq.compare(chunk.offset, overlap, chunk.seq, 0,
+                                  overlap) == 0;
+
+          seq.append(chunk.seq, overlap, std::string::npos);
+        }
+
+        // Only the last chunk of a record may be short.
+        chunks_ok = chunks_ok && chunk.seq.size() <= size &&
+                    (chunk.last || chunk.seq.size() == size);
+      }
+
+      REQUIRE(chunks_ok);
+      REQUIRE(result_names == names);
+      REQUIRE(result_seqs == seqs);
+    }
+  });
+}
+
+TEST_CASE("FastaReader w. chunk overlap not less than size throws", "[fasta_reader]") {
+  FastaReader reader("test/fasta_files/test1.fasta");
+  SeqChunk    chunk;
+
+  try {
+    reader.NextChunk(chunk, 10, 10);
+
+    FAIL("FastaReader did not throw expected exception");
+  }
+  catch (FastaReaderException& e) {
+    REQUIRE(e.exceptionMsg ==
+            "Error: Chunk overlap must be less than chunk size: 10 >= 10");
+  }
+}
+
+TEST_CASE("FastaReader w. batches", "[fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta";
+  FastaReader reader(file);
+  std::vector<SeqEntry> batch(5);
+
+  REQUIRE(reader.NextBatch(batch, 1) == 1);
+  REQUIRE(batch.size() == 1);
+  REQUIRE(batch[0].name() == "1 K#Bacteria;P#Proteobacteria");
+  REQUIRE(batch[0].seq() == "ATCGUatcgu");
+
+  REQUIRE(reader.NextBatch(batch, 10) == 1);
+  REQUIRE(batch.size() == 1);
+  REQUIRE(batch[0].name() == "1 K#Bacteria;P#Proteobacteria");
+  REQUIRE(batch[0].seq() == "atcgu");
+
+  REQUIRE(reader.NextBatch(batch, 10) == 0);
+  REQUIRE(batch.empty());
+}
+
+TEST_CASE("FastaReader w. unbounded batch", "[fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta";
+  FastaReader reader(file);
+  std::vector<SeqEntry> batch;
+
+  REQUIRE(reader.NextBatch(batch, std::numeric_limits<size_t>::max()) == 2);
+  REQUIRE(batch.size() == 2);
+  REQUIRE(batch[1].seq() == "atcgu");
+}
+
+TEST_CASE("FastaReader w. packed sequences", "[fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta";
+  FastaReader reader(file);
+
+  reader.set_packed(true);
+
+  auto entry = reader.NextEntry();
+
+  REQUIRE(entry->packed());
+  REQUIRE(entry->packed_seq().Unpack() == "ATCGNATCGN");
+
+  std::vector<SeqEntry> batch;
+
+  REQUIRE(reader.NextBatch(batch, 10) == 1);
+  REQUIRE(batch[0].packed());
+  REQUIRE(batch[0].packed_seq().Unpack() == "ATCGN");
+
+  FastaReader unpacked(file);
+
+  REQUIRE(unpacked.NextBatch(batch, 10) == 2);
+  REQUIRE_FALSE(batch[0].packed());
+  REQUIRE(batch[0].seq() == "ATCGUatcgu");
+}
+
+TEST_CASE("FastaReader packs single and multi-line records", "[fasta_reader]") {
+  const char  data[] = ">one\nACGTacgtNN\n>multi\nACG\nTTR\r\nA\n>last\nGATTACA";
+  FastaReader reader(data, sizeof(data) - 1);
+
+  reader.set_packed(true);
+
+  REQUIRE(reader.NextEntry()->packed_seq().Unpack() == "ACGTACGTNN");
+
+  auto multi = reader.NextEntry();
+  REQUIRE(multi->name() == "multi");
+  REQUIRE(multi->packed_seq().Unpack() == "ACGTTNA");
+
+  REQUIRE(reader.NextEntry()->packed_seq().Unpack() == "GATTACA");
+  REQUIRE_FALSE(reader.HasNextEntry());
+}
+
+TEST_CASE("FastaReader w. packed protein sequences throws", "[fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta";
+  FastaReader reader(file);
+
+  reader.set_type(SeqEntry::SeqType::protein);
+
+  try {
+    reader.set_packed(true);
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (FastaReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Only nucleotide sequences can be packed");
+  }
+
+  reader.set_type(SeqEntry::SeqType::nucleotide);
+  reader.set_packed(true);
+
+  try {
+    reader.set_type(SeqEntry::SeqType::protein);
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (FastaReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Only nucleotide sequences can be packed");
+  }
+}
+
+TEST_CASE("FastaReader w. multi-member gzip compressed file", "[fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta.gz";
+  FastaReader reader(file);
+
+  SECTION("Entries are read OK") {
+    REQUIRE(reader.HasNextEntry());
+
+    auto entry1 = reader.NextEntry();
+    REQUIRE(entry1->name() == "1 K#Bacteria;P#Proteobacteria");
+    REQUIRE(entry1->seq() == "ATCGUatcgu");
+
+    REQUIRE(reader.HasNextEntry());
+
+    auto entry2 = reader.NextEntry();
+    REQUIRE(entry2->name() == "1 K#Bacteria;P#Proteobacteria");
+    REQUIRE(entry2->seq() == "atcgu");
+
+    REQUIRE_FALSE(reader.HasNextEntry());
+  }
+}
+
+TEST_CASE("FastaReader w. BGZF compressed file", "[fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta.bgz";
+  FastaReader reader(file);
+
+  SECTION("Entries are read OK") {
+    REQUIRE(reader.HasNextEntry());
+
+    auto entry1 = reader.NextEntry();
+    REQUIRE(entry1->name() == "1 K#Bacteria;P#Proteobacteria");
+    REQUIRE(entry1->seq() == "ATCGUatcgu");
+
+    REQUIRE(reader.HasNextEntry());
+
+    auto entry2 = reader.NextEntry();
+    REQUIRE(entry2->name() == "1 K#Bacteria;P#Proteobacteria");
+    REQUIRE(entry2->seq() == "atcgu");
+
+    REQUIRE_FALSE(reader.HasNextEntry());
+  }
+}
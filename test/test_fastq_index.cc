@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "catch.hpp"
+#include <BioIO/bioio.h>
+
+namespace {
+
+/*
+ * Write count records of varying length to file and return their names.
+ * Scores starting with '@' or '+' and CRLF line ends make the record starts
+ * harder to find for SeekShard.
+ */
+std::vector<std::string> WriteRecords(const std::string &file,
+                                      const size_t count) {
+  std::vector<std::string> names;
+  std::ofstream            output(file, std::ofstream::binary);
+
+  for (size_t i = 0; i < count; ++i) {
+    std::string name   = "read" + std::to_string(i);
+    std::string seq(1 + i % 37, "ACGT"[i % 4]);
+    std::string scores(seq.size(), 'I');
+    std::string eol    = (i % 5 == 0) ? "\r\n" : "\n";
+
+    scores[0] = "@+I"[i % 3];
+
+    output << "@" << name << eol << seq << eol << "+" << eol << scores << eol;
+    names.push_back(name);
+  }
+
+  output.close();
+
+  return names;
+}
+
+}  // namespace
+
+TEST_CASE("FastqIndex", "[fastq_index]") {
+  std::string              file  = "test.fastq";
+  std::vector<std::string> names = WriteRecords(file, 1000);
+
+  FastqIndex index = FastqIndex::Build(file, 64);
+
+  REQUIRE(index.interval() == 64);
+  REQUIRE(index.records() == 1000);
+  REQUIRE(index.offsets().size() == 16);
+  REQUIRE(index.offsets()[0] == 0);
+
+  SECTION("SeekRecord continues at the given record") {
+    FastqReader reader(file);
+
+    for (uint64_t record : {999, 0, 63, 64, 65, 500, 128, 1}) {
+      reader.SeekRecord(index, record);
+
+      for (uint64_t i = record; i < record + 3 && i < 1000; ++i) {
+        REQUIRE(reader.HasNextEntry());
+        REQUIRE(reader.NextEntry()->name() == names[i]);
+      }
+    }
+
+    reader.SeekRecord(index, 999);
+    reader.NextView();
+
+    REQUIRE_FALSE(reader.HasNextEntry());
+  }
+
+  SECTION("SeekRecord past the last record throws") {
+    FastqReader reader(file);
+
+    try {
+      reader.SeekRecord(index, 1000);
+
+      FAIL("FastqReader did not throw expected exception");
+    }
+    catch (FastqIndexException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Record out of range: 1000 >= 1000");
+    }
+  }
+
+  SECTION("Saved index is loaded") {
+    index.Save("test.fastq.fqi");
+
+    FastqIndex loaded = FastqIndex::Load("test.fastq.fqi");
+
+    REQUIRE(loaded.interval() == index.interval());
+    REQUIRE(loaded.records() == index.records());
+    REQUIRE(loaded.offsets() == index.offsets());
+
+    remove("test.fastq.fqi");
+  }
+
+  SECTION("Truncated index file throws") {
+    index.Save("test.fastq.fqi");
+
+    std::ifstream input("test.fastq.fqi", std::ifstream::binary);
+    std::string   data((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+    input.close();
+
+    std::ofstream output("test.fastq.fqi", std::ofstream::binary);
+    output << data.substr(0, data.size() - 1);
+    output.close();
+
+    try {
+      FastqIndex::Load("test.fastq.fqi");
+
+      FAIL("FastqIndex did not throw expected exception");
+    }
+    catch (FastqIndexException& e) {
+      REQUIRE(e.exceptionMsg ==
+              "Error: malformed FASTQ index file: test.fastq.fqi");
+    }
+
+    remove("test.fastq.fqi");
+  }
+
+  SECTION("Index file with a huge record count throws") {
+    index.Save("test.fastq.fqi");
+
+    std::ifstream input("test.fastq.fqi", std::ifstream::binary);
+    std::string   data((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+    input.close();
+
+    // Interval 1 with 2^62 records and offsets in a file with only 16.
+    data.replace(4, 8, std::string("\x01\0\0\0\0\0\0\0", 8));
+    data.replace(12, 8, std::string("\0\0\0\0\0\0\0\x40", 8));
+    data.replace(20, 8, std::string("\0\0\0\0\0\0\0\x40", 8));
+
+    std::ofstream output("test.fastq.fqi", std::ofstream::binary);
+    output << data;
+    output.close();
+
+    try {
+      FastqIndex::Load("test.fastq.fqi");
+
+      FAIL("FastqIndex did not throw expected exception");
+    }
+    catch (FastqIndexException& e) {
+      REQUIRE(e.exceptionMsg ==
+              "Error: malformed FASTQ index file: test.fastq.fqi");
+    }
+
+    remove("test.fastq.fqi");
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastqReader shards", "[fastq_index]") {
+  std::string              file  = "test.fastq";
+  std::vector<std::string> names = WriteRecords(file, 300);
+
+  SECTION("Shards together hold every record once in order") {
+    for (size_t shards : {1, 2, 3, 5, 64, 5000}) {
+      std::vector<std::string> result;
+
+      for (size_t shard = 0; shard < shards; ++shard) {
+        FastqReader reader(file);
+
+        reader.SeekShard(shard, shards);
+
+        while (reader.HasNextEntry()) {
+          result.push_back(reader.NextEntry()->name());
+        }
+      }
+
+      REQUIRE(result == names);
+    }
+  }
+
+  SECTION("Shard out of range throws") {
+    FastqReader reader(file);
+
+    try {
+      reader.SeekShard(2, 2);
+
+      FAIL("FastqReader did not throw expected exception");
+    }
+    catch (FastqReaderException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Shard out of range: 2 >= 2");
+    }
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastqReader w. compressed file cannot shard", "[fastq_index]") {
+  FastqReader reader("test/fastq_files/test1.fastq.gz");
+
+  try {
+    reader.SeekShard(0, 2);
+
+    FAIL("FastqReader did not throw expected exception");
+  }
+  catch (ReadBufferException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Compressed input cannot seek");
+  }
+}
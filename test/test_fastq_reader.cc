@@ -20,7 +20,11 @@
 
 #include <string>
 #include <memory>
+#include <limits>
+#include <fstream>
+#include <sstream>
 #include "catch.hpp"
+#include "test_helpers.h"
 #include <BioIO/bioio.h>
 
 TEST_CASE("FastqReader w. OK entries", "[fastq_reader]") {
@@ -170,6 +174,134 @@ reader.NextEntry();
   }
 }
 
+TEST_CASE("FastqReader w. CRLF line-endings are OK", "[fastq_reader]") {
+  std::string file = "test/fastq_files/test14.fastq";
+  FastqReader reader(file);
+
+  static const uint8_t scores[] = {36, 37, 38, 39, 40};
+  const std::vector<uint8_t> v(scores, scores + sizeof(scores) / sizeof(scores[0]));
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry1 = reader.NextEntry();
+  REQUIRE(entry1->name() == "test1");
+  REQUIRE(entry1->seq() == "ATCGUatcgu");
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry2 = reader.NextEntry();
+  REQUIRE(entry2->name() == "test2");
+  REQUIRE(entry2->seq() == "natcg");
+  REQUIRE(entry2->scores() == v);
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+}
+
+TEST_CASE("FastqReader w. long reads", "[fastq_reader]") {
+  std::string file = "long.fastq";
+  std::string seq(1000000, 'A');
+  std::string scores(seq.size(), 'I');
+
+  std::ofstream output(file);
+  output << "@long" << std::endl << seq << std::endl << "+" << std::endl
+         << scores << std::endl;
+  output << "@short" << std::endl << "ATCG" << std::endl << "+" << std::endl
+         << "IIII" << std::endl;
+  output.close();
+
+  FastqReader reader(file);
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry1 = reader.NextEntry();
+  REQUIRE(entry1->name() == "long");
+  REQUIRE(entry1->seq() == seq);
+  REQUIRE(entry1->scores() == std::vector<uint8_t>(seq.size(), 40));
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry2 = reader.NextEntry();
+  REQUIRE(entry2->name() == "short");
+  REQUIRE(entry2->seq() == "ATCG");
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastqReader views match entries", "[fastq_reader]") {
+  std::string file  = "views.fastq";
+  size_t      count = 50000;
+
+  std::ostringstream output;
+
+  for (size_t i = 0; i < count; ++i) {
+    std::string eol = (i % 7 == 0) ? "\r\n" : "\n";
+    size_t      len = 1 + i % 150;
+
+    output << "@read" << i << eol << std::string(len, "ACGT"[i % 4]) << eol
+           << "+" << eol << std::string(len, '!' + i % 41) << eol;
+  }
+
+  CheckPlainAndGzip(file, output.str(), [&] {
+    FastqReader entries(file);
+    FastqReader views(file);
+
+    size_t n = 0;
+
+    while (views.HasNextEntry()) {
+      SeqView view = views.NextView();
+
+      if (!entries.HasNextEntry())
+        break;
+
+      auto entry = entries.NextEntry();
+      bool same  = view.name.str() == entry->name() &&
+                   view.seq.str() == entry->seq() &&
+                   view.scores.size == entry->scores().size();
+
+      for (size_t i = 0; same && i < view.scores.size; ++i)
+        same = view.scores[i] - 33 == entry->scores()[i];
+
+      if (!same)
+        break;
+
+      ++n;
+    }
+
+    REQUIRE(n == count);
+    REQUIRE_FALSE(entries.HasNextEntry());
+  });
+}
+
+TEST_CASE("FastqReader w. batches", "[fastq_reader]") {
+  std::string file = "test/fastq_files/test1.fastq";
+  FastqReader reader(file);
+  std::vector<SeqEntry> batch;
+
+  REQUIRE(reader.NextBatch(batch, 10) == 2);
+  REQUIRE(batch.size() == 2);
+  REQUIRE(batch[0].name() == "test1");
+  REQUIRE(batch[0].seq() == "ATCGUatcgu");
+  REQUIRE(batch[0].scores() == std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  REQUIRE(batch[1].name() == "test2");
+  REQUIRE(batch[1].seq() == "natcg");
+  REQUIRE(batch[1].scores() == std::vector<uint8_t>({36, 37, 38, 39, 40}));
+
+  REQUIRE(reader.NextBatch(batch, 10) == 0);
+  REQUIRE(batch.empty());
+}
+
+TEST_CASE("FastqReader w. unbounded batch", "[fastq_reader]") {
+  std::string file = "test/fastq_files/test1.fastq";
+  FastqReader reader(file);
+  std::vector<SeqEntry> batch;
+
+  REQUIRE(reader.NextBatch(batch, std::numeric_limits<size_t>::max()) == 2);
+  REQUIRE(batch.size() == 2);
+  REQUIRE(batch[1].scores() == std::vector<uint8_t>({36, 37, 38, 39, 40}));
+}
+
 TEST_CASE("FastqReader w. missing file throws", "[fastq_reader]") {
   try {
     FastqReader reader("blefh");
@@ -247,3 +379,206 @@ reader.NextEntry();
     REQUIRE_FALSE(reader.HasNextEntry());
   }
 }
+
+TEST_CASE("FastqReader w. scores below encoding throws", "[fastq_reader]") {
+  std::string data = "@test1\nATCG\n+\nII I\n";
+  FastqReader reader(data.data(), data.size());
+
+  try {
+    reader.NextEntry();
+
+    FAIL("FastqReader did not throw expected exception");
+  }
+  catch (FastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Score char 32 out of range for encoding 33");
+  }
+}
+
+TEST_CASE("FastqReader w. base 33 scores read as base 64 throws", "[fastq_reader]") {
+  std::string file = "test/fastq_files/test1.fastq";
+  FastqReader reader(file, 64);
+
+  try {
+    reader.NextEntry();
+
+    FAIL("FastqReader did not throw expected exception");
+  }
+  catch (FastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Score char 33 out of range for encoding 64");
+  }
+}
+
+TEST_CASE("FastqReader w. score modes", "[fastq_reader]") {
+  std::string file = "test/fastq_files/test1.fastq";
+  FastqReader reader(file);
+  const std::vector<uint8_t> scores1 = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  const std::vector<uint8_t> scores2 = {36, 37, 38, 39, 40};
+
+  SECTION("Lazy scores are decoded on first access") {
+    reader.set_score_mode(FastqReader::ScoreMode::lazy);
+
+    auto entry = reader.NextEntry();
+
+    REQUIRE(entry->raw_scores() == "!\"#$%&'()*");
+    REQUIRE(entry->scores() == scores1);
+    REQUIRE(entry->raw_scores().empty());
+  }
+
+  SECTION("Skipped scores are left empty") {
+    reader.set_score_mode(FastqReader::ScoreMode::skip);
+
+    auto entry = reader.NextEntry();
+
+    REQUIRE(entry->seq() == "ATCGUatcgu");
+    REQUIRE(entry->scores().empty());
+
+    SeqBatch batch;
+
+    REQUIRE(reader.NextBatch(batch, 10) == 1);
+    REQUIRE(batch.all_scores().empty());
+  }
+
+  SECTION("Reused entries switch between modes") {
+    std::vector<SeqEntry> batch;
+
+    reader.set_score_mode(FastqReader::ScoreMode::lazy);
+
+    REQUIRE(reader.NextBatch(batch, 1) == 1);
+    REQUIRE(batch[0].raw_scores() == "!\"#$%&'()*");
+
+    reader.set_score_mode(FastqReader::ScoreMode::decode);
+
+    REQUIRE(reader.NextBatch(batch, 1) == 1);
+    REQUIRE(batch[0].raw_scores().empty());
+    REQUIRE(batch[0].scores() == scores2);
+  }
+}
+
+TEST_CASE("FastqReader w. automatic encoding", "[fastq_reader]") {
+  SECTION("Phred+33 is detected") {
+    std::string file = "test/fastq_files/test1.fastq";
+    FastqReader reader(file, FastqReader::Encoding::automatic);
+
+    REQUIRE(reader.NextEntry()->scores() ==
+            std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    REQUIRE(reader.encoding() == FastqReader::Encoding::phred33);
+  }
+
+  SECTION("Phred+64 is detected") {
+    std::string file = "test/fastq_files/test13.fastq";
+    FastqReader reader(file, FastqReader::Encoding::automatic);
+
+    REQUIRE(reader.encoding() == FastqReader::Encoding::phred64);
+    REQUIRE(reader.NextEntry()->scores() ==
+            std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  }
+
+  SECTION("High Phred+33 scores are not taken for Phred+64") {
+    std::string   file = "high.fastq";
+    std::ofstream output(file);
+
+    output << "@test1\nACGT\n+\nFFJK\n@test2\nACGT\n+\nAAA@\n";
+    output.close();
+
+    FastqReader reader(file, FastqReader::Encoding::automatic);
+
+    REQUIRE(reader.encoding() == FastqReader::Encoding::phred33);
+
+    remove(file.c_str());
+  }
+
+  SECTION("Solexa is detected and converted to Phred") {
+    std::string   file = "solexa.fastq";
+    std::ofstream output(file);
+
+    output << "@test1\nACGT\n+\n;@Jh\n";
+    output.close();
+
+    FastqReader reader(file, FastqReader::Encoding::automatic);
+    std::vector<SeqEntry> batch;
+
+    reader.set_score_mode(FastqReader::ScoreMode::lazy);
+
+    REQUIRE(reader.NextBatch(batch, 10) == 1);
+    REQUIRE(reader.encoding() == FastqReader::Encoding::solexa);
+    REQUIRE(batch[0].scores() == std::vector<uint8_t>({1, 3, 10, 40}));
+
+    remove(file.c_str());
+  }
+
+  SECTION("Empty file defaults to Phred+33") {
+    std::string   file = "empty.fastq";
+    std::ofstream output(file);
+    output.close();
+
+    FastqReader reader(file, FastqReader::Encoding::automatic);
+
+    REQUIRE(reader.encoding() == FastqReader::Encoding::phred33);
+
+    remove(file.c_str());
+  }
+}
+
+TEST_CASE("FastqReader w. Solexa scores below -5 throws", "[fastq_reader]") {
+  std::string   file = "solexa.fastq";
+  std::ofstream output(file);
+
+  output << "@test1\nACGT\n+\n;:Jh\n";
+  output.close();
+
+  FastqReader reader(file, FastqReader::Encoding::solexa);
+
+  try {
+    reader.NextEntry();
+
+    FAIL("FastqReader did not throw expected exception");
+  }
+  catch (FastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Score char 58 out of range for encoding Solexa");
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("FastqReader w. packed sequences", "[fastq_reader]") {
+  FastqReader reader("test/fastq_files/test1.fastq");
+
+  reader.set_packed(true);
+
+  auto entry = reader.NextEntry();
+
+  REQUIRE(entry->packed());
+  REQUIRE(entry->packed_seq().Unpack() == "ATCGNATCGN");
+  REQUIRE(entry->scores().size() == 10);
+
+  std::vector<SeqEntry> batch;
+
+  REQUIRE(reader.NextBatch(batch, 10) == 1);
+  REQUIRE(batch[0].packed());
+  REQUIRE(batch[0].packed_seq().Unpack() == "NATCG");
+}
+
+TEST_CASE("FastqReader w. gzip compressed file", "[fastq_reader]") {
+  std::string file = "test/fastq_files/test1.fastq.gz";
+  FastqReader reader(file);
+
+  SECTION("Entries are read OK") {
+    static const uint8_t scores[] = {36, 37, 38, 39, 40};
+    const std::vector<uint8_t> v(scores, scores + sizeof(scores) / sizeof(scores[0]));
+
+    REQUIRE(reader.HasNextEntry());
+
+    auto entry1 = reader.NextEntry();
+    REQUIRE(entry1->name() == "test1");
+    REQUIRE(entry1->seq() == "ATCGUatcgu");
+
+    REQUIRE(reader.HasNextEntry());
+
+    auto entry2 = reader.NextEntry();
+    REQUIRE(entry2->name() == "test2");
+    REQUIRE(entry2->seq() == "natcg");
+    REQUIRE(entry2->scores() == v);
+
+    REQUIRE_FALSE(reader.HasNextEntry());
+  }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef BIOIO_TEST_HELPERS_H_
+#define BIOIO_TEST_HELPERS_H_
+
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <zlib.h>
+#include "catch.hpp"
+
+/*
+ * Write contents to file uncompressed and then gzip compressed, and run
+ * check after each, so the same records are read both from a memory mapped
+ * file and from streamed input. The file is removed afterwards.
+ */
+inline void CheckPlainAndGzip(const std::string &file,
+                              const std::string &contents,
+                              const std::function<void()> &check) {
+  {
+    INFO("Uncompressed file " << file);
+
+    std::ofstream plain(file);
+    plain << contents;
+    plain.close();
+
+    check();
+  }
+
+  {
+    INFO("Gzip compressed file " << file);
+
+    gzFile gz = gzopen(file.c_str(), "wb");
+    gzwrite(gz, contents.data(), contents.size());
+    gzclose(gz);
+
+    check();
+  }
+
+  remove(file.c_str());
+}
+
+#endif  // BIOIO_TEST_HELPERS_H_
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <fstream>
+#include "catch.hpp"
+#include <BioIO/bioio.h>
+
+TEST_CASE("IndexedFastaReader fetches regions", "[indexed_fasta_reader]") {
+  IndexedFastaReader reader("test/fasta_files/test12.fasta");
+
+  SECTION("Whole sequences are fetched") {
+    REQUIRE(reader.Fetch("chr1") == "ACGTACGTACGTACGTACGTACG");
+    REQUIRE(reader.Fetch("chr2") == "TTTTGGGGCCCCAA");
+    REQUIRE(reader.Fetch("HLA-A*01:01") == "ACGT");
+  }
+
+  SECTION("Regions are 1-based and inclusive") {
+    REQUIRE(reader.Fetch("chr1:1-4") == "ACGT");
+    REQUIRE(reader.Fetch("chr1:9-12") == "ACGT");
+    REQUIRE(reader.Fetch("chr1:21") == "ACG");
+    REQUIRE(reader.Fetch("chr2:1,0-1,2") == "CCC");
+    REQUIRE(reader.Fetch("chr2:13-1000") == "AA");
+    REQUIRE(reader.Fetch("HLA-A*01:01:2-3") == "CG");
+  }
+
+  SECTION("Ranges are 0-based and half-open") {
+    REQUIRE(reader.Fetch("chr1", 10, 20) == "GTACGTACGT");
+    REQUIRE(reader.Fetch("chr1", 5, 5) == "");
+    REQUIRE(reader.Fetch("chr1", 30, 40) == "");
+  }
+
+  SECTION("Unknown names throw") {
+    try {
+      reader.Fetch("chr3:1-10");
+
+      FAIL("Reader did not throw expected exception");
+    }
+    catch (IndexedFastaReaderException& e) {
+      REQUIRE(e.exceptionMsg == "Error: unknown sequence name: chr3");
+    }
+  }
+
+  SECTION("Invalid regions throw") {
+    try {
+      reader.Fetch("chr1:10-5");
+
+      FAIL("Reader did not throw expected exception");
+    }
+    catch (IndexedFastaReaderException& e) {
+      REQUIRE(e.exceptionMsg == "Error: invalid region: chr1:10-5");
+    }
+  }
+}
+
+TEST_CASE("IndexedFastaReader fetches regions from BGZF files", "[indexed_fasta_reader]") {
+  IndexedFastaReader plain("test/fasta_files/test12.fasta");
+
+  SECTION("Indexes are loaded from .fai and .gzi files") {
+    IndexedFastaReader reader("test/fasta_files/test12.fasta.bgz");
+
+    for (const auto &entry : plain.index().entries()) {
+      for (uint64_t begin = 0; begin < entry.length; ++begin) {
+        REQUIRE(reader.Fetch(entry.name, begin, begin + 7) ==
+                plain.Fetch(entry.name, begin, begin + 7));
+      }
+    }
+
+    REQUIRE(reader.Fetch("chr2:9-12") == "CCCC");
+  }
+
+  SECTION("Missing indexes are built") {
+    std::string file = "indexed.fasta.bgz";
+
+    std::ifstream input("test/fasta_files/test12.fasta.bgz", std::ifstream::binary);
+    std::ofstream output(file, std::ofstream::binary);
+    output << input.rdbuf();
+    output.close();
+
+    IndexedFastaReader reader(file);
+
+    REQUIRE(reader.index().size() == 3);
+    REQUIRE(reader.Fetch("chr1") == plain.Fetch("chr1"));
+    REQUIRE(reader.Fetch("HLA-A*01:01") == "ACGT");
+
+    remove(file.c_str());
+  }
+}
+
+TEST_CASE("IndexedFastaReader matches the sequence w/o index file", "[indexed_fasta_reader]") {
+  std::string file = "indexed.fasta";
+  std::string seq;
+
+  for (size_t i = 0; i < 10000; ++i) {
+    seq.push_back("ACGTN"[(i * 7) % 5]);
+  }
+
+  std::ofstream output(file);
+  output << ">first" << std::endl << "AC" << std::endl << ">second\r\n";
+
+  for (size_t i = 0; i < seq.size(); i += 61) {
+    output << seq.substr(i, 61) << "\r\n";
+  }
+
+  output.close();
+
+  IndexedFastaReader reader(file);
+
+  REQUIRE(reader.index().size() == 2);
+  REQUIRE(reader.Fetch("first") == "AC");
+
+  bool same = true;
+
+  for (uint64_t begin = 0; same && begin < seq.size(); begin += 97) {
+    for (uint64_t len : {1, 60, 61, 62, 500}) {
+      same = same && reader.Fetch("second", begin, begin + len) ==
+                     seq.substr(begin, len);
+    }
+  }
+
+  REQUIRE(same);
+
+  remove(file.c_str());
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include "catch.hpp"
+#include <BioIO/bioio.h>
+
+TEST_CASE("PackedSeq", "[packed_seq]") {
+  // 70 bases spans three words and two mask words.
+  std::string seq = "ACGTacgtAAAACCCCGGGGTTTTACGTACGTACGTACGTGATTACAGATTACA"
+                    "nACGTRYacgtACGTA";
+  PackedSeq   packed(seq);
+
+  REQUIRE(packed.size() == seq.size());
+  REQUIRE(packed.words().size() == 3);
+  REQUIRE(packed.mask().size() == 2);
+
+  SECTION("Unpacking gives upper case bases and N for other chars") {
+    std::string expected = "ACGTACGTAAAACCCCGGGGTTTTACGTACGTACGTACGTGATTACAGAT"
+                           "TACANACGTNNACGTACGTA";
+
+    REQUIRE(packed.Unpack() == expected);
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+      REQUIRE(packed[i] == expected[i]);
+    }
+  }
+
+  SECTION("Masked bases are reported") {
+    REQUIRE(packed.masked(54));
+    REQUIRE_FALSE(packed.masked(53));
+    REQUIRE(packed.masked(59, 2));
+    REQUIRE_FALSE(packed.masked(0, 54));
+    REQUIRE(packed.masked(0, 55));
+    REQUIRE_FALSE(packed.masked(61, 9));
+  }
+
+  SECTION("Mask is dropped without other chars") {
+    PackedSeq plain("ACGT");
+
+    REQUIRE(plain.mask().empty());
+    REQUIRE_FALSE(plain.masked(0, 4));
+    REQUIRE(plain.words()[0] == 0xe4);
+  }
+
+  SECTION("Kmer returns bases within and across words") {
+    REQUIRE(packed.Kmer(0, 4) == 0xe4);
+    REQUIRE(packed.Kmer(1, 3) == 0x39);
+    REQUIRE(packed.Kmer(0, 32) == packed.words()[0]);
+    REQUIRE(packed.Kmer(32, 32) == packed.words()[1]);
+    REQUIRE(packed.Kmer(30, 4) == PackedSeq("GTAC").Kmer(0, 4));
+    REQUIRE(packed.Kmer(5, 0) == 0);
+  }
+
+  SECTION("SubSeq slices the packed words and mask") {
+    std::string unpacked = packed.Unpack();
+    bool        same     = true;
+
+    for (size_t i = 0; i <= unpacked.size(); ++i) {
+      for (size_t len = 0; same && i + len <= unpacked.size(); ++len) {
+        PackedSeq sub = packed.SubSeq(i, len);
+
+        same = sub == PackedSeq(unpacked.substr(i, len)) &&
+               sub.mask().empty() == !packed.masked(i, len);
+      }
+    }
+
+    REQUIRE(same);
+  }
+
+  SECTION("SubSeq out of range throws") {
+    try {
+      packed.SubSeq(60, 11);
+
+      FAIL("PackedSeq did not throw expected exception");
+    }
+    catch (PackedSeqException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Subsequence out of range: 60 + 11 > 70");
+    }
+  }
+
+  SECTION("Kmer out of range throws") {
+    try {
+      packed.Kmer(60, 11);
+
+      FAIL("PackedSeq did not throw expected exception");
+    }
+    catch (PackedSeqException& e) {
+      REQUIRE(e.exceptionMsg == "Error: k-mer out of range: 60 + 11 > 70");
+    }
+
+    try {
+      packed.Kmer(0, 33);
+
+      FAIL("PackedSeq did not throw expected exception");
+    }
+    catch (PackedSeqException& e) {
+      REQUIRE(e.exceptionMsg == "Error: k-mer longer than 32 bases: 33");
+    }
+  }
+
+  SECTION("Sequences compare by packed words") {
+    REQUIRE(packed == PackedSeq(packed.Unpack()));
+    REQUIRE(PackedSeq("acgt") == PackedSeq("ACGT"));
+    REQUIRE(PackedSeq("ACGT") != PackedSeq("ACGA"));
+    REQUIRE(PackedSeq("ACGA") != PackedSeq("ACGN"));
+    REQUIRE(PackedSeq("ACG") != PackedSeq("ACGA"));
+  }
+
+  SECTION("Assign and clear replace the contents") {
+    packed.Assign("TTT", 3);
+
+    REQUIRE(packed.Unpack() == "TTT");
+    REQUIRE(packed.mask().empty());
+
+    packed.clear();
+
+    REQUIRE(packed.empty());
+    REQUIRE(packed.Unpack() == "");
+  }
+}
+
+TEST_CASE("PackedSeq w. empty sequence", "[packed_seq]") {
+  PackedSeq packed("");
+
+  REQUIRE(packed.empty());
+  REQUIRE(packed.words().empty());
+  REQUIRE(packed.mask().empty());
+  REQUIRE(packed.Unpack() == "");
+
+  packed.Assign("ACGT", 4);
+  packed.Assign("", 0);
+
+  REQUIRE(packed.empty());
+  REQUIRE(packed.Unpack() == "");
+}
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "catch.hpp"
+#include "test_helpers.h"
+#include <BioIO/bioio.h>
+
+namespace {
+
+/*
+ * Write count FASTQ records named @<prefix><i><suffix> to file.
+ */
+void WritePairedFastq(const std::string &file, const std::string &prefix,
+                      const std::string &suffix, const size_t count) {
+  std::ofstream output(file);
+
+  for (size_t i = 0; i < count; ++i) {
+    size_t len = 1 + i % 100;
+
+    output << "@" << prefix << i << suffix << "\n"
+           << std::string(len, "ACGT"[i % 4]) << "\n+\n"
+           << std::string(len, 'I') << "\n";
+  }
+}
+
+}  // namespace
+
+TEST_CASE("PairedFastqReader::MateName strips comment and mate suffix", "[paired_fastq_reader]") {
+  REQUIRE(PairedFastqReader::MateName(CharSpan("read1", 5)).str() == "read1");
+  REQUIRE(PairedFastqReader::MateName(CharSpan("read1/1", 7)).str() == "read1");
+  REQUIRE(PairedFastqReader::MateName(CharSpan("read1/2", 7)).str() == "read1");
+  REQUIRE(PairedFastqReader::MateName(CharSpan("read1/3", 7)).str() == "read1/3");
+  REQUIRE(PairedFastqReader::MateName(CharSpan("read1 1:N:0", 11)).str() == "read1");
+  REQUIRE(PairedFastqReader::MateName(CharSpan("read1/2\tx", 9)).str() == "read1");
+  REQUIRE(PairedFastqReader::MateName(CharSpan("/1", 2)).str() == "");
+}
+
+TEST_CASE("PairedFastqReader w. OK pairs", "[paired_fastq_reader]") {
+  std::string file1 = "paired_1.fastq";
+  std::string file2 = "paired_2.fastq";
+  size_t      count = 10000;
+
+  WritePairedFastq(file1, "read", "/1 1:N:0", count);
+  WritePairedFastq(file2, "read", "/2 2:N:0", count);
+
+  for (bool prefetch : {false, true}) {
+    for (size_t batch_size : {1, 7, 4096}) {
+      PairedFastqReader reader(file1, file2, prefetch,
+                               FastqReader::kDefaultEncoding, batch_size);
+      SeqBatch          batch1;
+      SeqBatch          batch2;
+      size_t            n    = 0;
+      bool              same = true;
+
+      while (reader.NextBatch(batch1, batch2)) {
+        same = same && batch1.size() == batch2.size() &&
+               batch1.size() <= batch_size;
+
+        for (size_t i = 0; same && i < batch1.size(); ++i, ++n) {
+          std::string name = "read" + std::to_string(n);
+
+          same = batch1.name(i).str() == name + "/1 1:N:0" &&
+                 batch2.name(i).str() == name + "/2 2:N:0" &&
+                 batch1.seq(i).size == 1 + n % 100;
+        }
+      }
+
+      REQUIRE(same);
+      REQUIRE(n == count);
+      REQUIRE(reader.NextBatch(batch1, batch2) == 0);
+    }
+  }
+
+  remove(file1.c_str());
+  remove(file2.c_str());
+}
+
+TEST_CASE("PairedFastqReader NextEntry returns pairs", "[paired_fastq_reader]") {
+  std::string file1 = "paired_1.fastq";
+  std::string file2 = "paired_2.fastq";
+
+  WritePairedFastq(file1, "read", "", 3);
+  WritePairedFastq(file2, "read", "", 3);
+
+  PairedFastqReader reader(file1, file2, true, FastqReader::kDefaultEncoding, 2);
+
+  for (size_t i = 0; i < 3; ++i) {
+    REQUIRE(reader.HasNextEntry());
+
+    auto pair = reader.NextEntry();
+    REQUIRE(pair.first->name() == "read" + std::to_string(i));
+    REQUIRE(pair.second->name() == "read" + std::to_string(i));
+    REQUIRE(pair.first->scores() == std::vector<uint8_t>(1 + i, 40));
+  }
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+
+  try {
+    reader.NextEntry();
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (PairedFastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: no more entries");
+  }
+
+  remove(file1.c_str());
+  remove(file2.c_str());
+}
+
+TEST_CASE("PairedFastqReader w. mismatching mate names throws", "[paired_fastq_reader]") {
+  std::string file1 = "paired_1.fastq";
+  std::string file2 = "paired_2.fastq";
+
+  WritePairedFastq(file1, "read", "/1", 10);
+  WritePairedFastq(file2, "mate", "/2", 10);
+
+  for (bool prefetch : {false, true}) {
+    PairedFastqReader reader(file1, file2, prefetch);
+    SeqBatch          batch1;
+    SeqBatch          batch2;
+
+    try {
+      reader.NextBatch(batch1, batch2);
+
+      FAIL("Reader did not throw expected exception");
+    }
+    catch (PairedFastqReaderException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Mate names differ at pair 1: read0/1 != mate0/2");
+    }
+  }
+
+  remove(file1.c_str());
+  remove(file2.c_str());
+}
+
+TEST_CASE("PairedFastqReader w. files of different length throws", "[paired_fastq_reader]") {
+  std::string file1 = "paired_1.fastq";
+  std::string file2 = "paired_2.fastq";
+
+  WritePairedFastq(file1, "read", "/1", 10);
+  WritePairedFastq(file2, "read", "/2", 9);
+
+  for (bool prefetch : {false, true}) {
+    PairedFastqReader reader(file1, file2, prefetch,
+                             FastqReader::kDefaultEncoding, 4);
+    SeqBatch          batch1;
+    SeqBatch          batch2;
+
+    REQUIRE(reader.NextBatch(batch1, batch2) == 4);
+    REQUIRE(reader.NextBatch(batch1, batch2) == 4);
+
+    // The error is thrown again rather than taken for end-of-file.
+    for (int i = 0; i < 2; i++) {
+      try {
+        reader.NextBatch(batch1, batch2);
+
+        FAIL("Reader did not throw expected exception");
+      }
+      catch (PairedFastqReaderException& e) {
+        REQUIRE(e.exceptionMsg == "Error: Paired files differ in length after 9 pairs");
+      }
+    }
+  }
+
+  remove(file1.c_str());
+  remove(file2.c_str());
+}
+
+TEST_CASE("PairedFastqReader w. interleaved file", "[paired_fastq_reader]") {
+  std::string file  = "interleaved.fastq";
+  size_t      count = 10000;
+
+  // Quality lines starting with '@' and '+' look like record starts and
+  // comment lines, and R2 records look like pair starts to a cut that only
+  // checks record starts, so chunks must be cut at verified pairs.
+  std::ostringstream output;
+
+  for (size_t i = 0; i < 2 * count; ++i) {
+    std::string eol    = (i % 7 == 0) ? "\r\n" : "\n";
+    size_t      len    = 1 + i % 150;
+    std::string scores = std::string(1, "@+I"[i % 3]) +
+                         std::string(len - 1, '!' + i % 41);
+
+    output << "@read" << i / 2 << "/" << 1 + i % 2 << eol
+           << std::string(len, "ACGT"[i % 4]) << eol << "+" << eol << scores;
+
+    if (i + 1 < 2 * count)
+      output << eol;
+  }
+
+  CheckPlainAndGzip(file, output.str(), [&] {
+    for (size_t threads : {1, 3}) {
+      for (size_t chunk_size : {100, 4096, 1024 * 1024}) {
+        PairedFastqReader reader(file, threads, FastqReader::kDefaultEncoding,
+                                 chunk_size);
+        SeqBatch          batch1;
+        SeqBatch          batch2;
+        size_t            n    = 0;
+        bool              same = true;
+
+        while (same && reader.NextBatch(batch1, batch2)) {
+          same = batch1.size() == batch2.size();
+
+          for (size_t i = 0; same && i < batch1.size(); ++i, ++n) {
+            std::string    name = "read" + std::to_string(n);
+            size_t         len1;
+            size_t         len2;
+            const uint8_t *scores1 = batch1.scores(i, len1);
+            const uint8_t *scores2 = batch2.scores(i, len2);
+
+            same = batch1.name(i).str() == name + "/1" &&
+                   batch2.name(i).str() == name + "/2" &&
+                   batch1.seq(i).size == 1 + 2 * n % 150 &&
+                   batch2.seq(i).size == 1 + (2 * n + 1) % 150 &&
+                   len1 == batch1.seq(i).size && len2 == batch2.seq(i).size &&
+                   (len1 == 1 || scores1[len1 - 1] == 2 * n % 41) &&
+                   (len2 == 1 || scores2[len2 - 1] == (2 * n + 1) % 41);
+          }
+        }
+
+        REQUIRE(same);
+        REQUIRE(n == count);
+      }
+    }
+  });
+}
+
+TEST_CASE("PairedFastqReader interleaved NextEntry returns pairs", "[paired_fastq_reader]") {
+  std::string file = "interleaved.fastq";
+
+  {
+    std::ofstream output(file);
+    output << "@a/1\nAC\n+\nII\n@a/2\nGT\n+\nII\n"
+           << "@b 1:N:0\nA\n+\nI\n@b 2:N:0\nC\n+\nI\n";
+  }
+
+  PairedFastqReader reader(file, 2);
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto pair1 = reader.NextEntry();
+  REQUIRE(pair1.first->name() == "a/1");
+  REQUIRE(pair1.first->seq() == "AC");
+  REQUIRE(pair1.second->name() == "a/2");
+  REQUIRE(pair1.second->seq() == "GT");
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto pair2 = reader.NextEntry();
+  REQUIRE(pair2.first->name() == "b 1:N:0");
+  REQUIRE(pair2.second->name() == "b 2:N:0");
+  REQUIRE(pair2.second->scores() == std::vector<uint8_t>({40}));
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+
+  remove(file.c_str());
+}
+
+TEST_CASE("PairedFastqReader w. interleaved unpaired mate throws", "[paired_fastq_reader]") {
+  std::string file = "interleaved.fastq";
+
+  {
+    std::ofstream output(file);
+    output << "@a/1\nAC\n+\nII\n@a/2\nGT\n+\nII\n@b/1\nA\n+\nI\n";
+  }
+
+  PairedFastqReader reader(file, 2);
+  SeqBatch          batch1;
+  SeqBatch          batch2;
+
+  try {
+    reader.NextBatch(batch1, batch2);
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (PairedFastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Interleaved input ends with an unpaired mate: b/1");
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("PairedFastqReader w. interleaved mismatching mate names throws", "[paired_fastq_reader]") {
+  std::string file = "interleaved.fastq";
+
+  {
+    std::ofstream output(file);
+    output << "@a/1\nAC\n+\nII\n@a/2\nGT\n+\nII\n"
+           << "@b/1\nA\n+\nI\n@c/2\nC\n+\nI\n";
+  }
+
+  PairedFastqReader reader(file, 2);
+  SeqBatch          batch1;
+  SeqBatch          batch2;
+
+  try {
+    reader.NextBatch(batch1, batch2);
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (PairedFastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Mate names differ at pair 2: b/1 != c/2");
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("PairedFastqReader w. interleaved mismatch in a later chunk throws", "[paired_fastq_reader]") {
+  std::string file = "interleaved.fastq";
+
+  {
+    std::ofstream output(file);
+
+    for (size_t i = 0; i < 100; ++i) {
+      std::string name = "r" + std::to_string(i);
+
+      output << "@" << name << "/1\nACGT\n+\nIIII\n"
+             << "@" << ((i == 59) ? "x59" : name) << "/2\nTGCA\n+\nIIII\n";
+    }
+  }
+
+  PairedFastqReader reader(file, 2, FastqReader::kDefaultEncoding, 64);
+  SeqBatch          batch1;
+  SeqBatch          batch2;
+  size_t            pairs = 0;
+
+  try {
+    while (size_t n = reader.NextBatch(batch1, batch2)) {
+      pairs += n;
+    }
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (PairedFastqReaderException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Mate names differ at pair 60: r59/1 != x59/2");
+  }
+
+  REQUIRE(pairs < 60);
+
+  remove(file.c_str());
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "catch.hpp"
+#include "test_helpers.h"
+#include <BioIO/bioio.h>
+
+TEST_CASE("ParallelFastaReader w. OK entries", "[parallel_fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta";
+  ParallelFastaReader reader(file, 2);
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry1 = reader.NextEntry();
+  REQUIRE(entry1->name() == "1 K#Bacteria;P#Proteobacteria");
+  REQUIRE(entry1->seq() == "ATCGUatcgu");
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry2 = reader.NextEntry();
+  REQUIRE(entry2->name() == "1 K#Bacteria;P#Proteobacteria");
+  REQUIRE(entry2->seq() == "atcgu");
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+}
+
+TEST_CASE("ParallelFastaReader matches FastaReader", "[parallel_fasta_reader]") {
+  std::string file  = "parallel.fasta";
+  size_t      count = 20000;
+
+  std::ostringstream output;
+
+  for (size_t i = 0; i < count; ++i) {
+    std::string eol = (i % 7 == 0) ? "\r\n" : "\n";
+
+    output << ">seq" << i << eol << std::string(1 + i % 90, "ACGT"[i % 4]);
+
+    if (i % 3 == 0)
+      output << eol << "NN>N";
+
+    if (i + 1 < count)
+      output << eol;
+  }
+
+  CheckPlainAndGzip(file, output.str(), [&] {
+    std::vector<std::string> expected;
+    FastaReader              serial(file);
+
+    while (serial.HasNextEntry()) {
+      auto entry = serial.NextEntry();
+
+      expected.push_back(entry->name() + " " + entry->seq());
+    }
+
+    REQUIRE(expected.size() == count);
+
+    std::vector<std::string> sorted(expected);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t threads : {1, 3}) {
+      for (size_t chunk_size : {10, 4096, 1024 * 1024}) {
+        for (auto delivery : {ParallelFastaReader::Delivery::ordered,
+                              ParallelFastaReader::Delivery::unordered}) {
+          ParallelFastaReader      parallel(file, threads, delivery, chunk_size);
+          SeqBatch                 batch;
+          std::vector<std::string> records;
+
+          while (parallel.NextBatch(batch)) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+              records.push_back(batch.name(i).str() + " " + batch.seq(i).str());
+            }
+          }
+
+          if (delivery == ParallelFastaReader::Delivery::unordered) {
+            std::sort(records.begin(), records.end());
+            REQUIRE(records == sorted);
+          } else {
+            REQUIRE(records == expected);
+          }
+        }
+      }
+    }
+  });
+}
+
+TEST_CASE("ParallelFastaReader w. protein sequences", "[parallel_fasta_reader]") {
+  std::string file = "test/fasta_files/test1.fasta";
+  ParallelFastaReader reader(file, 2, ParallelFastaReader::Delivery::ordered,
+                             ParallelFastaReader::kDefaultChunkSize,
+                             SeqEntry::SeqType::protein);
+
+  REQUIRE(reader.HasNextEntry());
+  REQUIRE(reader.NextEntry()->type() == SeqEntry::SeqType::protein);
+}
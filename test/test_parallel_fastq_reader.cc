@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include "catch.hpp"
+#include "test_helpers.h"
+#include <BioIO/bioio.h>
+
+TEST_CASE("ParallelFastqReader w. OK entries", "[parallel_fastq_reader]") {
+  std::string file = "test/fastq_files/test1.fastq";
+  ParallelFastqReader reader(file, 2);
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry1 = reader.NextEntry();
+  REQUIRE(entry1->name() == "test1");
+  REQUIRE(entry1->seq() == "ATCGUatcgu");
+  REQUIRE(entry1->scores() == std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+  REQUIRE(reader.HasNextEntry());
+
+  auto entry2 = reader.NextEntry();
+  REQUIRE(entry2->name() == "test2");
+  REQUIRE(entry2->seq() == "natcg");
+  REQUIRE(entry2->scores() == std::vector<uint8_t>({36, 37, 38, 39, 40}));
+
+  REQUIRE_FALSE(reader.HasNextEntry());
+}
+
+TEST_CASE("ParallelFastqReader matches FastqReader", "[parallel_fastq_reader]") {
+  std::string file  = "parallel.fastq";
+  size_t      count = 20000;
+
+  // Quality lines starting with '@' and '+' look like record starts and
+  // comment lines, so chunks must not be cut there.
+  std::ostringstream output;
+
+  for (size_t i = 0; i < count; ++i) {
+    std::string eol    = (i % 7 == 0) ? "\r\n" : "\n";
+    size_t      len    = 1 + i % 150;
+    std::string scores = std::string(1, "@+I"[i % 3]) +
+                         std::string(len - 1, '!' + i % 41);
+
+    output << "@read" << i << eol << std::string(len, "ACGT"[i % 4]) << eol
+           << "+" << eol << scores;
+
+    if (i + 1 < count)
+      output << eol;
+  }
+
+  CheckPlainAndGzip(file, output.str(), [&] {
+    for (size_t threads : {1, 3}) {
+      for (size_t chunk_size : {100, 4096, 1024 * 1024}) {
+        FastqReader         serial(file);
+        ParallelFastqReader parallel(file, threads,
+                                     FastqReader::kDefaultEncoding, chunk_size);
+        SeqBatch            batch;
+        size_t              n    = 0;
+        bool                same = true;
+
+        while (same && parallel.NextBatch(batch)) {
+          for (size_t i = 0; same && i < batch.size(); ++i, ++n) {
+            auto           entry = serial.NextEntry();
+            size_t         len;
+            const uint8_t *scores = batch.scores(i, len);
+
+            same = batch.name(i).str() == entry->name() &&
+                   batch.seq(i).str() == entry->seq() &&
+                   std::vector<uint8_t>(scores, scores + len) == entry->scores();
+          }
+        }
+
+        REQUIRE(same);
+        REQUIRE(n == count);
+        REQUIRE_FALSE(serial.HasNextEntry());
+      }
+    }
+  });
+}
+
+TEST_CASE("ParallelFastqReader w. non-equal length seq and scores throws", "[parallel_fastq_reader]") {
+  ParallelFastqReader reader("test/fastq_files/test12.fastq", 2);
+  SeqBatch            batch;
+
+  try {
+    reader.NextBatch(batch);
+
+    FAIL("Reader did not throw expected exception");
+  }
+  catch (FastqReaderException& e) {
+    REQUIRE(e.exceptionMsg.find("Error: Sequence length != scores length") == 0);
+  }
+}
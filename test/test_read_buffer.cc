@@ -20,6 +20,7 @@
 
 #include <string>
 #include <fstream>
+#include <unistd.h>
 #include "catch.hpp"
 #include "BioIO/read_buffer.h"
 
@@ -74,5 +75,503 @@ TEST_CASE("ReadBuffer", "[read_buffer]") {
     REQUIRE(rb.PrevChar() == c1);
   }
 
+  SECTION("NextChar from memory mapped file") {
+    string result   = "";
+    ReadBuffer rb(2, file, ReadBuffer::Mode::mmap);
+
+    REQUIRE(rb.mapped());
+    REQUIRE(rb.decompress_threads() == 0);
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+    REQUIRE(rb.Eof());
+  }
+
+  SECTION("NextChar from stream") {
+    string result   = "";
+    ReadBuffer rb(2, file, ReadBuffer::Mode::stream);
+
+    REQUIRE_FALSE(rb.mapped());
+    REQUIRE_FALSE(rb.async());
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+    REQUIRE(rb.Eof());
+  }
+
+  SECTION("NextChar with read-ahead") {
+    string result   = "";
+    ReadBuffer rb(2, file, ReadBuffer::Mode::async);
+
+    REQUIRE_FALSE(rb.mapped());
+    REQUIRE(rb.async());
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+    REQUIRE(rb.Eof());
+    REQUIRE(rb.Offset() == 9);
+  }
+
+  SECTION("Read-ahead stopped before end-of-file") {
+    ReadBuffer rb(2, file, ReadBuffer::Mode::async);
+
+    REQUIRE(rb.NextChar() == 'f');
+  }
+
+  SECTION("Offset and Size are tracked across buffer loads") {
+    ReadBuffer rb(2, file, ReadBuffer::Mode::stream);
+
+    REQUIRE(rb.Size() == 9);
+    REQUIRE(rb.Offset() == 0);
+
+    for (int i = 0; i < 5; ++i) {
+      rb.NextChar();
+    }
+
+    REQUIRE(rb.Offset() == 5);
+    rb.Rewind(1);
+    REQUIRE(rb.Offset() == 4);
+
+    while (rb.NextChar()) {}
+
+    REQUIRE(rb.Offset() == 9);
+  }
+
+  SECTION("Offset in memory mapped file") {
+    ReadBuffer rb(2, file, ReadBuffer::Mode::mmap);
+
+    REQUIRE(rb.Size() == 9);
+
+    while (rb.NextChar()) {}
+
+    REQUIRE(rb.Offset() == 9);
+  }
+
+  SECTION("LineSpan returns lines across buffer loads") {
+    ReadBuffer rb(3, file, ReadBuffer::Mode::stream);
+
+    string      line = "";
+    size_t      len;
+    bool        eol;
+    const char *span;
+
+    while ((span = rb.LineSpan(len, eol))) {
+      line.append(span, len);
+      rb.Skip(len);
+
+      if (eol) {
+        break;
+      }
+    }
+
+    REQUIRE(line == "fox");
+    rb.SkipEol();
+    REQUIRE(rb.NextChar() == 'b');
+  }
+
+  SECTION("LineSpan in memory mapped file") {
+    ReadBuffer rb(3, file, ReadBuffer::Mode::mmap);
+
+    size_t      len;
+    bool        eol;
+    const char *span = rb.LineSpan(len, eol);
+
+    REQUIRE(string(span, len) == "fox");
+    REQUIRE(eol);
+
+    rb.Skip(len);
+    rb.SkipEol();
+
+    span = rb.LineSpan(len, eol);
+
+    REQUIRE(string(span, len) == "barz");
+    REQUIRE(eol);
+
+    rb.Skip(len);
+    rb.SkipEol();
+
+    REQUIRE(rb.LineSpan(len, eol) == nullptr);
+    REQUIRE(rb.Eof());
+  }
+
+  SECTION("Rewind in memory mapped file") {
+    ReadBuffer rb(20, file, ReadBuffer::Mode::mmap);
+
+    REQUIRE(rb.NextChar() == 'f');
+    REQUIRE(rb.NextChar() == 'o');
+    rb.Rewind(1);
+    REQUIRE(rb.NextChar() == 'o');
+    REQUIRE(rb.PrevChar() == 'f');
+  }
+
+  SECTION("Seek continues at offset in each mode") {
+    for (auto mode : {ReadBuffer::Mode::mmap, ReadBuffer::Mode::stream,
+                      ReadBuffer::Mode::async}) {
+      ReadBuffer rb(2, file, mode);
+
+      REQUIRE(rb.NextChar() == 'f');
+      REQUIRE(rb.NextChar() == 'o');
+      REQUIRE(rb.NextChar() == 'x');
+
+      rb.Seek(5);
+
+      REQUIRE(rb.Offset() == 5);
+      REQUIRE(rb.NextChar() == 'a');
+      REQUIRE(rb.NextChar() == 'r');
+
+      rb.Seek(1);
+
+      REQUIRE(rb.NextChar() == 'o');
+      REQUIRE(rb.Offset() == 2);
+
+      rb.Seek(9);
+
+      REQUIRE(rb.Eof());
+      REQUIRE(rb.Offset() == 9);
+    }
+  }
+
+  SECTION("Seek after end-of-file continues reading") {
+    ReadBuffer rb(2, file, ReadBuffer::Mode::async);
+
+    while (rb.NextChar()) {}
+
+    rb.Seek(4);
+
+    REQUIRE(rb.NextChar() == 'b');
+  }
+
   remove(file.c_str());
 }
+
+TEST_CASE("ReadBuffer w. missing file throws", "[read_buffer]") {
+  try {
+    ReadBuffer rb(20, "blefh", ReadBuffer::Mode::mmap);
+
+    FAIL("ReadBuffer did not throw expected exception");
+  }
+  catch (ReadBufferException& e) {
+    REQUIRE(e.exceptionMsg == "Error: File could not be memory mapped: blefh");
+  }
+}
+
+TEST_CASE("ReadBuffer w. gzip compressed file", "[read_buffer]") {
+  string file     = "test/fastq_files/test1.fastq.gz";
+  string expected = "@test1\nATCGUatcgu\n+\n!\"#$%&'()*\n@test2\nnatcg\n+\nEFGHI\n";
+
+  SECTION("NextChar decompresses with read-ahead") {
+    string result = "";
+    ReadBuffer rb(3, file);
+
+    REQUIRE_FALSE(rb.mapped());
+    REQUIRE(rb.async());
+    REQUIRE(rb.compressed());
+    REQUIRE(rb.decompress_threads() == 0);
+    REQUIRE(rb.Size() == 0);
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+    REQUIRE(rb.Offset() == expected.size());
+  }
+
+  SECTION("NextChar decompresses synchronously") {
+    string result = "";
+    ReadBuffer rb(3, file, ReadBuffer::Mode::stream);
+
+    REQUIRE_FALSE(rb.async());
+    REQUIRE(rb.compressed());
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+  }
+
+  SECTION("Memory mapping a compressed file throws") {
+    try {
+      ReadBuffer rb(3, file, ReadBuffer::Mode::mmap);
+
+      FAIL("ReadBuffer did not throw expected exception");
+    }
+    catch (ReadBufferException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Compressed file cannot be memory mapped: " + file);
+    }
+  }
+
+  SECTION("Seek in compressed file throws") {
+    ReadBuffer rb(3, file, ReadBuffer::Mode::stream);
+
+    try {
+      rb.Seek(1);
+
+      FAIL("ReadBuffer did not throw expected exception");
+    }
+    catch (ReadBufferException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Compressed input cannot seek");
+    }
+  }
+}
+
+TEST_CASE("ReadBuffer w. BGZF compressed file", "[read_buffer]") {
+  string file = "test/fasta_files/test1.fasta.bgz";
+
+  ifstream input("test/fasta_files/test1.fasta");
+  string   expected((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+  SECTION("Blocks inflated on one thread are read in order") {
+    string result = "";
+    ReadBuffer rb(3, file, ReadBuffer::Mode::stream, 1);
+
+    REQUIRE(rb.compressed());
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+  }
+
+  SECTION("Blocks inflated on many threads are read in order") {
+    string result = "";
+    ReadBuffer rb(7, file, ReadBuffer::Mode::async, 4);
+
+    REQUIRE(rb.compressed());
+    REQUIRE(rb.decompress_threads() == 4);
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+  }
+}
+
+TEST_CASE("ReadBuffer w. corrupt BGZF block throws", "[read_buffer]") {
+  string file = "file.bgz";
+
+  ifstream input("test/fasta_files/test1.fasta.bgz", ios::binary);
+  string   data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+  // Flip a bit in the CRC32 of the first block.
+  size_t block_size = (static_cast<unsigned char>(data[16]) |
+                       (static_cast<unsigned char>(data[17]) << 8)) + 1;
+  data[block_size - 8] ^= 1;
+
+  ofstream output(file, ios::binary);
+  output << data;
+  output.close();
+
+  try {
+    ReadBuffer rb(3, file, ReadBuffer::Mode::automatic, 2);
+
+    while (rb.NextChar()) {}
+
+    FAIL("ReadBuffer did not throw expected exception");
+  }
+  catch (ReadBufferException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Failed to decompress BGZF block");
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("ReadBuffer w. corrupt BGZF block keeps throwing", "[read_buffer]") {
+  string file = "file.bgz";
+
+  ifstream input("test/fasta_files/test1.fasta.bgz", ios::binary);
+  string   data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+  size_t block_size = (static_cast<unsigned char>(data[16]) |
+                       (static_cast<unsigned char>(data[17]) << 8)) + 1;
+  data[block_size - 8] ^= 1;
+
+  ofstream output(file, ios::binary);
+  output << data;
+  output.close();
+
+  // Without read-ahead every NextChar reaches the decompressor itself.
+  ReadBuffer rb(3, file, ReadBuffer::Mode::stream, 2);
+
+  for (int i = 0; i < 2; i++) {
+    try {
+      while (rb.NextChar()) {}
+
+      FAIL("ReadBuffer did not throw expected exception");
+    }
+    catch (ReadBufferException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Failed to decompress BGZF block");
+    }
+  }
+
+  remove(file.c_str());
+}
+
+TEST_CASE("ReadBuffer w. oversized BGZF block throws", "[read_buffer]") {
+  string file = "file.bgz";
+
+  ifstream input("test/fasta_files/test1.fasta.bgz", ios::binary);
+  string   data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+  // Claim an inflated size of 4 GiB - 1 in the trailer of the first block.
+  size_t block_size = (static_cast<unsigned char>(data[16]) |
+                       (static_cast<unsigned char>(data[17]) << 8)) + 1;
+  data.replace(block_size - 4, 4, 4, '\xff');
+
+  ofstream output(file, ios::binary);
+  output << data;
+  output.close();
+
+  try {
+    ReadBuffer rb(3, file, ReadBuffer::Mode::automatic, 2);
+
+    while (rb.NextChar()) {}
+
+    FAIL("ReadBuffer did not throw expected exception");
+  }
+  catch (ReadBufferException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Invalid BGZF block header");
+  }
+
+  remove(file.c_str());
+}
+
+static string ReadAll(ReadBuffer &rb) {
+  string result = "";
+  char   c;
+
+  while ((c = rb.NextChar())) {
+    result += c;
+  }
+
+  return result;
+}
+
+TEST_CASE("ReadBuffer w. other compression formats", "[read_buffer]") {
+  ifstream input("test/fastq_files/test1.fastq");
+  string   expected((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+#ifdef BIOIO_HAVE_BZIP2
+  SECTION("Multi-stream bzip2 file is decompressed") {
+    ReadBuffer rb(3, "test/fastq_files/test1.fastq.bz2");
+
+    REQUIRE(rb.compressed());
+    REQUIRE(ReadAll(rb) == expected);
+  }
+#endif
+
+#ifdef BIOIO_HAVE_LZMA
+  SECTION("xz file is decompressed") {
+    ReadBuffer rb(3, "test/fastq_files/test1.fastq.xz", ReadBuffer::Mode::async, 2);
+
+    REQUIRE(rb.compressed());
+    REQUIRE(ReadAll(rb) == expected);
+  }
+#endif
+
+#ifdef BIOIO_HAVE_ZSTD
+  SECTION("Multi-frame zstd file with skippable frame is decompressed") {
+    ReadBuffer rb(3, "test/fastq_files/test1.fastq.zst", ReadBuffer::Mode::async, 2);
+
+    REQUIRE(rb.compressed());
+    REQUIRE(ReadAll(rb) == expected);
+  }
+#else
+  SECTION("zstd file throws without zstd support") {
+    try {
+      ReadBuffer rb(3, "test/fastq_files/test1.fastq.zst");
+
+      FAIL("ReadBuffer did not throw expected exception");
+    }
+    catch (ReadBufferException& e) {
+      REQUIRE(e.exceptionMsg == "Error: BioIO was built without support for "
+                                "the compression format of file: "
+                                "test/fastq_files/test1.fastq.zst");
+    }
+  }
+#endif
+}
+
+TEST_CASE("ReadBuffer w. truncated gzip file throws", "[read_buffer]") {
+  string file = "file.gz";
+
+  ifstream input("test/fastq_files/test1.fastq.gz", ios::binary);
+  string   data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+  ofstream output(file, ios::binary);
+  output << data.substr(0, data.size() / 2);
+  output.close();
+
+  try {
+    ReadBuffer rb(3, file);
+
+    while (rb.NextChar()) {}
+
+    FAIL("ReadBuffer did not throw expected exception");
+  }
+  catch (ReadBufferException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Unexpected end of gzip compressed input");
+  }
+
+  remove(file.c_str());
+}
+
+#ifdef __linux__
+TEST_CASE("ReadBuffer w. pipe", "[read_buffer]") {
+  int fds[2];
+
+  REQUIRE(pipe(fds) == 0);
+
+  string expected = "fox\nbarz\n";
+
+  REQUIRE(write(fds[1], expected.data(), expected.size()) == 9);
+  close(fds[1]);
+
+  SECTION("NextChar streams until end-of-file") {
+    string result = "";
+    ReadBuffer rb(2, "/dev/fd/" + to_string(fds[0]));
+
+    REQUIRE_FALSE(rb.mapped());
+    REQUIRE(rb.async());
+    REQUIRE(rb.Size() == 0);
+
+    char c;
+
+    while ((c = rb.NextChar())) {
+      result += c;
+    }
+
+    REQUIRE(expected == result);
+    REQUIRE(rb.Eof());
+    REQUIRE(rb.Offset() == 9);
+  }
+
+  close(fds[0]);
+}
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "catch.hpp"
+
+#include <vector>
+#include <cstring>
+#include <BioIO/bioio.h>
+
+TEST_CASE("SeqBatch stores records back to back", "[seq_batch]") {
+  SeqBatch batch;
+
+  REQUIRE(batch.empty());
+
+  uint8_t *scores = batch.Append(CharSpan("r1", 2), CharSpan("ACGT", 4), 4);
+  memcpy(scores, "\x01\x02\x03\x04", 4);
+  batch.Append(CharSpan("r2", 2), CharSpan("GG", 2));
+
+  REQUIRE(batch.size() == 2);
+  REQUIRE(batch.name(0).str() == "r1");
+  REQUIRE(batch.seq(0).str() == "ACGT");
+  REQUIRE(batch.name(1).str() == "r2");
+  REQUIRE(batch.seq(1).str() == "GG");
+
+  size_t len;
+  REQUIRE(batch.scores(0, len)[3] == 4);
+  REQUIRE(len == 4);
+  batch.scores(1, len);
+  REQUIRE(len == 0);
+
+  REQUIRE(batch.names() == "r1r2");
+  REQUIRE(batch.seqs() == "ACGTGG");
+  REQUIRE(batch.seq_offsets() == std::vector<size_t>({0, 4, 6}));
+
+  SeqEntry entry = batch.Entry(0);
+  REQUIRE(entry.name() == "r1");
+  REQUIRE(entry.seq() == "ACGT");
+  REQUIRE(entry.scores() == std::vector<uint8_t>({1, 2, 3, 4}));
+
+  SECTION("Clear keeps the capacity") {
+    size_t capacity = batch.seqs().capacity();
+
+    batch.clear();
+
+    REQUIRE(batch.empty());
+    REQUIRE(batch.seqs().empty());
+    REQUIRE(batch.seqs().capacity() == capacity);
+    REQUIRE(batch.seq_offsets() == std::vector<size_t>({0}));
+  }
+}
+
+TEST_CASE("SeqBatch is filled by the readers", "[seq_batch]") {
+  SeqBatch batch;
+
+  SECTION("FASTA batches") {
+    FastaReader reader("test/fasta_files/test1.fasta");
+
+    REQUIRE(reader.NextBatch(batch, 1) == 1);
+    REQUIRE(batch.size() == 1);
+    REQUIRE(batch.seq(0).str() == "ATCGUatcgu");
+
+    REQUIRE(reader.NextBatch(batch, 10) == 1);
+    REQUIRE(batch.size() == 1);
+    REQUIRE(batch.name(0).str() == "1 K#Bacteria;P#Proteobacteria");
+    REQUIRE(batch.seq(0).str() == "atcgu");
+
+    REQUIRE(reader.NextBatch(batch, 10) == 0);
+    REQUIRE(batch.empty());
+  }
+
+  SECTION("FASTQ batches") {
+    FastqReader reader("test/fastq_files/test1.fastq");
+
+    REQUIRE(reader.NextBatch(batch, 10) == 2);
+    REQUIRE(batch.names() == "test1test2");
+    REQUIRE(batch.seqs() == "ATCGUatcgunatcg");
+    REQUIRE(batch.all_scores() ==
+            std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                  36, 37, 38, 39, 40}));
+    REQUIRE(batch.score_offsets() == std::vector<size_t>({0, 10, 15}));
+
+    REQUIRE(reader.NextBatch(batch, 10) == 0);
+  }
+}
+
+TEST_CASE("SeqBatch entries keep the sequence type", "[seq_batch]") {
+  SeqBatch batch;
+
+  REQUIRE(batch.type() == SeqEntry::SeqType::nucleotide);
+
+  const char  protein[] = ">p1\nMKVLAT\n>p2\nWQERTY\n";
+  FastaReader reader(protein, sizeof(protein) - 1);
+
+  reader.set_type(SeqEntry::SeqType::protein);
+
+  REQUIRE(reader.NextBatch(batch, 10) == 2);
+  REQUIRE(batch.type() == SeqEntry::SeqType::protein);
+
+  SeqEntry entry = batch.Entry(1);
+  REQUIRE(entry.name() == "p2");
+  REQUIRE(entry.seq() == "WQERTY");
+  REQUIRE(entry.type() == SeqEntry::SeqType::protein);
+
+  batch.clear();
+  REQUIRE(batch.type() == SeqEntry::SeqType::protein);
+
+  SECTION("FASTQ batches are nucleotide") {
+    FastqReader fastq("test/fastq_files/test1.fastq");
+
+    REQUIRE(fastq.NextBatch(batch, 10) == 2);
+    REQUIRE(batch.Entry(0).type() == SeqEntry::SeqType::nucleotide);
+  }
+}
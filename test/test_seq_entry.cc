@@ -206,3 +206,129 @@ TEST_CASE("SeqEntry.Size()", "[sequence]") {
     REQUIRE(s3.Size() == 4);
   }
 }
+
+TEST_CASE("sequences can be packed", "[sequence]") {
+  SeqEntry entry("Name", "ACGTNacgt", {1, 2, 3, 4, 5, 6, 7, 8, 9},
+                 SeqEntry::SeqType::nucleotide);
+
+  entry.Pack();
+
+  REQUIRE(entry.packed());
+  REQUIRE(entry.seq() == "");
+  REQUIRE(entry.Size() == 9);
+  REQUIRE(entry.packed_seq().Unpack() == "ACGTNACGT");
+
+  SECTION("Unpack restores the sequence in upper case") {
+    entry.Unpack();
+
+    REQUIRE_FALSE(entry.packed());
+    REQUIRE(entry.seq() == "ACGTNACGT");
+  }
+
+  SECTION("Subsequences of packed sequences are packed") {
+    SeqEntry sub = entry.SubSeq(3, 3);
+
+    REQUIRE(sub.packed());
+    REQUIRE(sub.packed_seq().Unpack() == "TNA");
+    REQUIRE(sub.scores() == std::vector<uint8_t>({4, 5, 6}));
+  }
+
+  SECTION("Packed sequences are reversed") {
+    entry.reverse();
+
+    REQUIRE(entry.packed());
+    REQUIRE(entry.packed_seq().Unpack() == "TGCANTGCA");
+    REQUIRE(entry.scores()[0] == 9);
+  }
+
+  SECTION("Packed sequences are printed unpacked") {
+    std::ostringstream output;
+
+    output << entry;
+
+    REQUIRE(output.str() == ">Name\nACGTNACGT");
+  }
+
+  SECTION("set_seq replaces a packed sequence") {
+    entry.set_seq("TT");
+
+    REQUIRE_FALSE(entry.packed());
+    REQUIRE(entry.Size() == 2);
+  }
+}
+
+TEST_CASE("empty sequences can be packed", "[sequence]") {
+  SeqEntry entry("Name", "", {}, SeqEntry::SeqType::nucleotide);
+
+  entry.Pack();
+
+  REQUIRE(entry.Size() == 0);
+  REQUIRE(entry.packed_seq().Unpack() == "");
+
+  entry.Unpack();
+
+  REQUIRE(entry.seq() == "");
+}
+
+TEST_CASE("protein sequences cannot be packed", "[sequence]") {
+  SeqEntry entry("Name", "MKVLAT", {}, SeqEntry::SeqType::protein);
+
+  try {
+    entry.Pack();
+
+    FAIL("Pack did not throw expected exception");
+  }
+  catch (SeqEntryException& e) {
+    REQUIRE(e.exceptionMsg == "Error: Only nucleotide sequences can be packed");
+  }
+
+  REQUIRE_FALSE(entry.packed());
+  REQUIRE(entry.seq() == "MKVLAT");
+}
+
+TEST_CASE("raw scores are decoded on first access", "[sequence]") {
+  SeqEntry entry("Name", "ACGT", {}, SeqEntry::SeqType::nucleotide);
+
+  entry.set_raw_scores("!\"#I", 4, 33);
+
+  REQUIRE(entry.raw_scores() == "!\"#I");
+
+  SECTION("Subsequences and reversed entries keep raw scores") {
+    SeqEntry sub = entry.SubSeq(1, 2);
+
+    REQUIRE(sub.raw_scores() == "\"#");
+    REQUIRE(sub.scores() == std::vector<uint8_t>({1, 2}));
+
+    entry.reverse();
+
+    REQUIRE(entry.raw_scores() == "I#\"!");
+  }
+
+  SECTION("Copies decode on their own") {
+    const SeqEntry copy(entry);
+
+    REQUIRE(copy.scores() == std::vector<uint8_t>({0, 1, 2, 40}));
+    REQUIRE(copy.raw_scores().empty());
+    REQUIRE(entry.raw_scores() == "!\"#I");
+  }
+
+  SECTION("set_scores replaces raw scores") {
+    entry.set_scores({7});
+
+    REQUIRE(entry.raw_scores().empty());
+    REQUIRE(entry.scores() == std::vector<uint8_t>({7}));
+  }
+
+  SECTION("Scores out of range throw when decoded") {
+    entry.set_raw_scores("I I", 3, 33);
+
+    try {
+      entry.scores();
+
+      FAIL("SeqEntry did not throw expected exception");
+    }
+    catch (SeqEntryException& e) {
+      REQUIRE(e.exceptionMsg == "Error: Score char 32 out of range for encoding 33");
+    }
+  }
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2015 BIO-DIKU.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <vector>
+#include <algorithm>
+#include "catch.hpp"
+#include <BioIO/simd.h>
+
+static const char *FindEolExpected(const char *begin, const char *end) {
+  while (begin < end && *begin != '\n' && *begin != '\r') {
+    ++begin;
+  }
+
+  return begin;
+}
+
+static const char *FindNonSeqExpected(const char *begin, const char *end) {
+  while (begin < end && *begin >= 33 && *begin <= 126) {
+    ++begin;
+  }
+
+  return begin;
+}
+
+TEST_CASE("Simd kernels agree with scalar scanning", "[simd]") {
+  Simd::Level levels[] = { Simd::Level::scalar, Simd::Level::sse2,
+                           Simd::Level::avx2, Simd::Level::avx512bw };
+
+  srand(42);
+
+  for (Simd::Level level : levels) {
+    Simd::set_level(level);
+
+    REQUIRE(Simd::level() <= Simd::MaxLevel());
+
+    for (int i = 0; i < 1000; ++i) {
+      size_t      size = rand() % 100;
+      std::string data(size, 'A');
+
+      // Sprinkle a few stop chars, including chars above 127.
+      for (int j = rand() % 3; j > 0 && size > 0; --j) {
+        const char stops[] = { '\n', '\r', ' ', '\t', '\x7f', '\x80', '\xff' };
+        data[rand() % size] = stops[rand() % sizeof(stops)];
+      }
+
+      size_t start = size ? rand() % size : 0;
+
+      const char *begin = data.data() + start;
+      const char *end   = data.data() + size;
+
+      REQUIRE(Simd::FindEol(begin, end) == FindEolExpected(begin, end));
+      REQUIRE(Simd::FindNonSeq(begin, end) == FindNonSeqExpected(begin, end));
+    }
+  }
+
+  Simd::set_level(Simd::MaxLevel());
+}
+
+TEST_CASE("Simd 2-bit packing agrees with scalar packing", "[simd]") {
+  Simd::Level levels[] = { Simd::Level::scalar, Simd::Level::sse2,
+                           Simd::Level::avx2, Simd::Level::avx512bw };
+
+  srand(42);
+
+  for (Simd::Level level : levels) {
+    Simd::set_level(level);
+
+    for (int i = 0; i < 1000; ++i) {
+      size_t      size = rand() % 300;
+      std::string seq(size, 'A');
+
+      // Mostly bases in either case with a few other chars.
+      for (auto &c : seq) {
+        const char chars[] = "ACGTacgtACGTacgtNnRY-\xff";
+        c = chars[rand() % (sizeof(chars) - 1)];
+      }
+
+      // Start part way into a string, so loads are unaligned.
+      size_t      start = size ? rand() % 8 % size : 0;
+      const char *begin = seq.data() + start;
+      size_t      len   = size - start;
+
+      std::vector<uint64_t> words((len + 31) / 32, ~uint64_t(0));
+      std::vector<uint64_t> mask((len + 63) / 64, ~uint64_t(0));
+      std::vector<uint64_t> expected_words((len + 31) / 32, 0);
+      std::vector<uint64_t> expected_mask((len + 63) / 64, 0);
+      std::string           expected_seq(len, 'N');
+
+      for (size_t j = 0; j < len; ++j) {
+        const char *base = strchr("ACGT", toupper(begin[j]));
+
+        if (begin[j] && base) {
+          expected_words[j / 32] |= uint64_t(base - "ACGT") << (2 * (j % 32));
+          expected_seq[j] = *base;
+        } else {
+          expected_mask[j / 64] |= uint64_t(1) << (j % 64);
+        }
+      }
+
+      Simd::Pack2Bit(begin, len, words.data(), mask.data());
+
+      REQUIRE(words == expected_words);
+      REQUIRE(mask == expected_mask);
+
+      std::string unpacked(len, '\0');
+
+      Simd::Unpack2Bit(words.data(), mask.data(), len, &unpacked[0]);
+
+      REQUIRE(unpacked == expected_seq);
+    }
+  }
+
+  Simd::set_level(Simd::MaxLevel());
+}
+
+TEST_CASE("Simd score decoding agrees with scalar decoding", "[simd]") {
+  Simd::Level levels[] = { Simd::Level::scalar, Simd::Level::sse2,
+                           Simd::Level::avx2, Simd::Level::avx512bw };
+
+  srand(42);
+
+  for (Simd::Level level : levels) {
+    Simd::set_level(level);
+
+    for (int i = 0; i < 1000; ++i) {
+      size_t      size   = rand() % 200;
+      uint8_t     offset = (i % 2) ? 64 : 33;
+      std::string src(size, 'I');
+
+      for (auto &c : src) {
+        c = offset + rand() % (127 - offset);
+      }
+
+      // Make every other string invalid somewhere, including just outside
+      // the range and above 127.
+      bool valid = (i % 4 < 2) || size == 0;
+
+      if (!valid) {
+        const char bad[] = { static_cast<char>(offset - 1), '\x7f', '\x80',
+                             '\xff', '\n' };
+        src[rand() % size] = bad[rand() % sizeof(bad)];
+      }
+
+      std::vector<uint8_t> scores(size, 0xaa);
+
+      REQUIRE(Simd::DecodeScores(src.data(), size, offset, scores.data()) ==
+              valid);
+
+      if (valid) {
+        for (size_t j = 0; j < size; ++j) {
+          REQUIRE(scores[j] == static_cast<uint8_t>(src[j] - offset));
+        }
+      }
+    }
+  }
+
+  Simd::set_level(Simd::MaxLevel());
+}
+
+TEST_CASE("Simd min and max agree with scalar scanning", "[simd]") {
+  Simd::Level levels[] = { Simd::Level::scalar, Simd::Level::sse2,
+                           Simd::Level::avx2, Simd::Level::avx512bw };
+
+  srand(42);
+
+  for (Simd::Level level : levels) {
+    Simd::set_level(level);
+
+    for (int i = 0; i < 1000; ++i) {
+      size_t      size = rand() % 200;
+      std::string data(size, 'I');
+
+      for (auto &c : data) {
+        c = 33 + rand() % 94;
+      }
+
+      // Include chars above 127 now and then.
+      if (size && i % 5 == 0) {
+        data[rand() % size] = '\xf0';
+      }
+
+      uint8_t expected_min = 255;
+      uint8_t expected_max = 0;
+
+      for (const char c : data) {
+        expected_min = std::min(expected_min, static_cast<uint8_t>(c));
+        expected_max = std::max(expected_max, static_cast<uint8_t>(c));
+      }
+
+      uint8_t min = 255;
+      uint8_t max = 0;
+
+      Simd::MinMax(data.data(), data.data() + size, min, max);
+
+      REQUIRE(min == expected_min);
+      REQUIRE(max == expected_max);
+    }
+  }
+
+  Simd::set_level(Simd::MaxLevel());
+}